@@ -0,0 +1,188 @@
+#include "Checkpoint.hxx"
+#include "SkimIndex.hxx"
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <utility>
+
+const int Checkpoint::kVersion = 2;
+
+namespace
+{
+    const char* const kCheckpointMagic = "test_analysis-checkpoint";
+
+    template <class T>
+    void WriteList(std::ostream& out, const char* inName, const std::vector<T>& inList)
+    {
+        out << inName << " " << inList.size();
+        for (const T& tempValue : inList)
+        {
+            out << " " << tempValue;
+        }
+        out << "\n";
+    }
+
+    template <class T>
+    bool ReadList(std::istream& in, const char* inName, std::vector<T>& outList)
+    {
+        std::string tempName;
+        std::size_t tempSize = 0;
+        in >> tempName >> tempSize;
+        if (!in || tempName != inName)
+        {
+            return false;
+        }
+        outList.resize(tempSize);
+        for (T& tempValue : outList)
+        {
+            in >> tempValue;
+        }
+        return static_cast<bool>(in);
+    }
+}
+
+Checkpoint::Checkpoint(const std::string& inFileName)
+    : mFileName(inFileName), mSelectedFileName(inFileName + ".selected")
+{
+}
+
+const std::string& Checkpoint::GetFileName() const
+{
+    return this->mFileName;
+}
+
+bool Checkpoint::Load(CheckpointState& outState, std::vector<Long64_t>& outSelected)
+{
+    std::ifstream tempFile(this->mFileName);
+    if (!tempFile)
+    {
+        return false;
+    }
+
+    std::string tempMagic;
+    int tempVersion = -1;
+    int tempSelectionVersion = -1;
+    std::size_t tempNumberOfInputFiles = 0;
+    tempFile >> tempMagic >> tempVersion >> tempSelectionVersion >> tempNumberOfInputFiles;
+    if (!tempFile
+            || tempMagic != kCheckpointMagic
+            || tempVersion != kVersion
+            || tempSelectionVersion != SkimIndex::kSelectionVersion)
+    {
+        return false;
+    }
+    tempFile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    CheckpointState tempState;
+    for (std::size_t i = 0; i < tempNumberOfInputFiles; ++i)
+    {
+        std::string tempInputFile;
+        std::getline(tempFile, tempInputFile);
+        tempState.inputFiles.push_back(tempInputFile);
+    }
+    tempFile >> tempState.numberOfEntries
+        >> tempState.first >> tempState.last >> tempState.next
+        >> tempState.numberOfSummaryRows;
+    if (!tempFile
+            || !ReadList(tempFile, "deltaTNeutron", tempState.deltaTNeutron)
+            || !ReadList(tempFile, "deltaTOther", tempState.deltaTOther)
+            || !ReadList(tempFile, "passed", tempState.passed))
+    {
+        return false;
+    }
+    std::string tempName;
+    tempFile >> tempName >> tempState.numberOfSelected;
+    if (!tempFile || tempName != "selected" || tempState.numberOfSelected < 0)
+    {
+        return false;
+    }
+
+    // entries after numberOfSelected are of a save which did not complete
+    std::vector<Long64_t> tempSelected(tempState.numberOfSelected);
+    std::ifstream tempSelectedFile(this->mSelectedFileName, std::ios::binary);
+    tempSelectedFile.read(reinterpret_cast<char*>(tempSelected.data()),
+            tempSelected.size() * sizeof(Long64_t));
+    if (!tempSelectedFile)
+    {
+        return false;
+    }
+    this->mNumberOfSavedSelected = tempState.numberOfSelected;
+    outState = std::move(tempState);
+    outSelected = std::move(tempSelected);
+    return true;
+}
+
+bool Checkpoint::Save(const CheckpointState& inState, const std::vector<Long64_t>& inSelected)
+{
+    if (static_cast<Long64_t>(inSelected.size()) < this->mNumberOfSavedSelected)
+    {
+        return false;
+    }
+    {
+        // append after the saved entries, a tail of an incomplete save is overwritten
+        std::fstream tempSelectedFile;
+        if (this->mNumberOfSavedSelected > 0)
+        {
+            tempSelectedFile.open(this->mSelectedFileName, std::ios::in | std::ios::out | std::ios::binary);
+            tempSelectedFile.seekp(this->mNumberOfSavedSelected * sizeof(Long64_t));
+        }
+        else
+        {
+            tempSelectedFile.open(this->mSelectedFileName, std::ios::out | std::ios::trunc | std::ios::binary);
+        }
+        tempSelectedFile.write(reinterpret_cast<const char*>(inSelected.data() + this->mNumberOfSavedSelected),
+                (inSelected.size() - this->mNumberOfSavedSelected) * sizeof(Long64_t));
+        tempSelectedFile.flush();
+        if (!tempSelectedFile)
+        {
+            return false;
+        }
+    }
+    this->mNumberOfSavedSelected = inSelected.size();
+
+    // same as SkimIndex: never leave a truncated checkpoint behind
+    const std::string tempFileName = this->mFileName + ".tmp";
+    {
+        std::ofstream tempFile(tempFileName);
+        if (!tempFile)
+        {
+            return false;
+        }
+        // full precision, so a resumed run has the same histograms
+        tempFile.precision(17);
+        tempFile << kCheckpointMagic << " " << kVersion << " "
+            << SkimIndex::kSelectionVersion << " " << inState.inputFiles.size() << "\n";
+        for (const std::string& tempInputFile : inState.inputFiles)
+        {
+            tempFile << tempInputFile << "\n";
+        }
+        tempFile << inState.numberOfEntries << " "
+            << inState.first << " " << inState.last << " " << inState.next << " "
+            << inState.numberOfSummaryRows << "\n";
+        WriteList(tempFile, "deltaTNeutron", inState.deltaTNeutron);
+        WriteList(tempFile, "deltaTOther", inState.deltaTOther);
+        WriteList(tempFile, "passed", inState.passed);
+        tempFile << "selected " << inSelected.size() << "\n";
+        if (!tempFile)
+        {
+            return false;
+        }
+    }
+    return std::rename(tempFileName.c_str(), this->mFileName.c_str()) == 0;
+}
+
+void Checkpoint::Remove()
+{
+    std::remove(this->mFileName.c_str());
+    std::remove(this->mSelectedFileName.c_str());
+    this->mNumberOfSavedSelected = 0;
+}
+
+bool Checkpoint::IsSameRun(const CheckpointState& inState, const CheckpointState& inOtherState)
+{
+    return inState.inputFiles == inOtherState.inputFiles
+        && inState.numberOfEntries == inOtherState.numberOfEntries
+        && inState.first == inOtherState.first
+        && inState.last == inOtherState.last;
+}
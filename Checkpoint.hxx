@@ -0,0 +1,111 @@
+#ifndef CHECKPOINT_HXX
+#define CHECKPOINT_HXX
+
+#include <Rtypes.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief state of a partially processed run
+ * @details key (inputs, range) identifies the run, the rest is the
+ * result of all entries before next.
+ */
+struct CheckpointState
+{
+    std::vector<std::string> inputFiles;
+    Long64_t numberOfEntries = 0;
+    Long64_t first = 0; //first position of the run
+    Long64_t last = 0; //last position of the run, not included
+    Long64_t next = 0; //first position not processed yet
+    Long64_t numberOfSummaryRows = 0;
+    std::vector<double> deltaTNeutron; //HistogramBuffer contents
+    std::vector<double> deltaTOther; //HistogramBuffer contents
+    std::vector<Long64_t> passed; //RunStatistics cut flow
+    Long64_t numberOfSelected = 0; //entries in the selected file
+};
+
+/**
+ * @brief Checkpoint class
+ * @details Checkpoint is a small text file with CheckpointState of a
+ * run, written after every block of entries. \n
+ * A rerun with the same inputs and range resumes from the state,
+ * instead of starting again from the first entry. The file is replaced
+ * atomically, so a crashed job leaves the last complete checkpoint. \n
+ * Selected entries are appended to a binary "<file>.selected" file,
+ * only the entries selected since the previous save are written, and
+ * the checkpoint keeps their number.
+ * @date 2026-10-17
+ */
+class Checkpoint
+{
+    public:
+        /**
+         * @brief version of the checkpoint format
+         */
+        static const int kVersion;
+
+        /**
+         * @brief initializer
+         * @param const std::string& inFileName: checkpoint file name
+         */
+        Checkpoint(const std::string& inFileName);
+
+        /**
+         * @brief get checkpoint file name
+         */
+        const std::string& GetFileName() const;
+
+        /**
+         * @brief load state from checkpoint file
+         * @details the next Save() appends after the loaded entries.
+         * @param CheckpointState& outState: loaded state
+         * @param std::vector<Long64_t>& outSelected: selected entries
+         * of the loaded state
+         * @return bool false if file is missing, broken, or of other
+         * format or selection version
+         */
+        bool Load(CheckpointState& outState, std::vector<Long64_t>& outSelected);
+
+        /**
+         * @brief save state to checkpoint file
+         * @details entries of inSelected after the previous save are
+         * appended to the selected file, numberOfSelected of inState
+         * is not used.
+         * @param const std::vector<Long64_t>& inSelected: all selected
+         * entries of the run so far
+         * @return bool false if file cannot be written
+         */
+        bool Save(const CheckpointState& inState, const std::vector<Long64_t>& inSelected);
+
+        /**
+         * @brief remove checkpoint and selected file
+         * @details called when the run is complete, the next Save()
+         * starts a new selected file.
+         */
+        void Remove();
+
+        /**
+         * @brief check if state is of the same run
+         * @return bool true if inputs and range are the same
+         */
+        static bool IsSameRun(const CheckpointState& inState, const CheckpointState& inOtherState);
+
+    private:
+        /**
+         * @brief checkpoint file name
+         */
+        std::string mFileName;
+
+        /**
+         * @brief selected file name
+         */
+        std::string mSelectedFileName;
+
+        /**
+         * @brief number of entries in the selected file
+         */
+        Long64_t mNumberOfSavedSelected = 0;
+};
+
+#endif
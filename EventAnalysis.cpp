@@ -1,24 +1,114 @@
 #include "EventAnalysis.hxx"
 
-Cube::Event* gEvent = NULL;
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
-void EventAnalysis::Add(Cube::Handle<Cube::AlgorithmResult> inResult)
+void EventAnalysis::Reset(Cube::Event* inEvent)
+{
+    this->mEvent = inEvent;
+    this->mTrack.clear();
+    this->mCluster.clear();
+    this->mObjects = Cube::Handle<Cube::ReconObjectContainer>();
+    this->mTimeOrderedObjects.clear();
+    this->mTimeOrder.clear();
+    this->mTruthIndex.Clear();
+    this->mSnapshot.Clear();
+    this->mSpatialIndexBuilt = false;
+    this->mNumberOfPrimaryAntiMuonTrajectory = 0;
+    this->mNumberOfPrimaryAntiMuonObject = 0;
+    this->mNumberOfPrimaryPionTrajectory = 0;
+    this->mVertex = TLorentzVector();
+    this->mFirstObject = Cube::Handle<Cube::ReconObject>();
+    this->mFirstObjectIndex = -1;
+}
+
+EventAnalysis::Status EventAnalysis::SetTruthCounters()
+{
+    int tempNumberOfPrimaryPionTrajectory = 0;
+    int tempNumberOfPrimaryAntiMuonTrajectory = 0;
+    for (Cube::Event::G4TrajectoryContainer::iterator g4Trajectory
+            = this->mEvent->G4Trajectories.begin();
+            g4Trajectory != this->mEvent->G4Trajectories.end();
+            ++g4Trajectory)
+    {
+        const Cube::Handle<Cube::G4Trajectory>& gt = g4Trajectory->second; //trajectory
+        if (gt->GetParentId() != -1)
+        {
+            continue;
+        }
+        const int tempPDGCode = gt->GetPDGCode();
+        if (std::abs(tempPDGCode) == 211 || tempPDGCode == 111)
+        {
+            tempNumberOfPrimaryPionTrajectory++;
+        }
+        else if (tempPDGCode == -13)
+        {
+            tempNumberOfPrimaryAntiMuonTrajectory++;
+        }
+    }
+    this->mNumberOfPrimaryPionTrajectory = tempNumberOfPrimaryPionTrajectory;
+    this->mNumberOfPrimaryAntiMuonTrajectory = tempNumberOfPrimaryAntiMuonTrajectory;
+    return kSuccess;
+}
+
+EventAnalysis::Status EventAnalysis::CollectObjects(Cube::Handle<Cube::AlgorithmResult> inResult,
+        const int* inMainTrajectories, int inNumberOfMainTrajectories)
+{
+    this->mTruthIndex.Build(this->mEvent);
+    Status tempStatus = this->Add(inResult);
+    if (tempStatus != kSuccess)
+    {
+        return tempStatus;
+    }
+    if (inMainTrajectories && this->mObjects
+            && (inNumberOfMainTrajectories < 0
+                || static_cast<std::size_t>(inNumberOfMainTrajectories) == this->mObjects->size()))
+    {
+        for (std::size_t i = 0; i < this->mObjects->size(); ++i)
+        {
+            this->mTruthIndex.SetMainTrajectory((*this->mObjects)[i], inMainTrajectories[i]);
+        }
+    }
+    this->BuildSnapshot();
+    this->SortObjectsByTime();
+    return kSuccess;
+}
+
+const char* EventAnalysis::GetStatusMessage(Status inStatus)
+{
+    switch (inStatus)
+    {
+        case kSuccess:
+            return "success";
+        case kNoObjectContainer:
+            return "Object container size = 0";
+        case kNoVertexCandidate:
+            return "no vertex candidate";
+        case kNoFirstObjectCandidate:
+            return "no first object candidate";
+    }
+    return "unknown status";
+}
+
+EventAnalysis::Status EventAnalysis::Add(Cube::Handle<Cube::AlgorithmResult> inResult)
 {
     if (inResult->GetObjectContainers().size() == 0)
     {
-        throw std::runtime_error("Object container size = 0");
+        return kNoObjectContainer;
     }
     for (Cube::AlgorithmResult::ReconObjects::reverse_iterator o = inResult->GetObjectContainers().rbegin();
             o != inResult->GetObjectContainers().rend(); 
             ++o) 
     {
         Cube::Handle<Cube::ReconObjectContainer> objects
-            = gEvent->GetObjectContainer((*o)->GetName());
+            = this->mEvent->GetObjectContainer((*o)->GetName());
 
-        if (objects)
+        if (!objects)
         {
-            this->mObjects = objects;
+            continue;
         }
+        this->mObjects = objects;
 
         for (Cube::ReconObjectContainer::iterator obj = objects->begin();
                 obj != objects->end(); ++obj) 
@@ -36,6 +126,12 @@ void EventAnalysis::Add(Cube::Handle<Cube::AlgorithmResult> inResult)
             }
         }
     }
+    return kSuccess;
+}
+
+Cube::Event* EventAnalysis::GetEvent() const
+{
+    return this->mEvent;
 }
 
 const std::vector<Cube::Handle<Cube::ReconTrack>>& EventAnalysis::GetTrackVector() const
@@ -53,45 +149,9 @@ const Cube::Handle<Cube::ReconObjectContainer>& EventAnalysis::GetObjects() cons
         return this->mObjects;
 }
 
-int EventAnalysis::SetNumberOfPrimaryAntiMuonTrajectory()
-{
-    int tempNumberOfPrimaryAntiMuonTrajectory = 0;
-    for (Cube::Event::G4TrajectoryContainer::iterator g4Trajectory
-            = gEvent->G4Trajectories.begin();
-            g4Trajectory != gEvent->G4Trajectories.end();
-            ++g4Trajectory) 
-    {
-        Cube::Handle<Cube::G4Trajectory> gt = g4Trajectory->second; //trajectory
-        if (gt->GetParentId() == -1)
-        {
-            if (gt->GetPDGCode() == -13)
-            {
-                tempNumberOfPrimaryAntiMuonTrajectory++;
-            }
-        }
-    }
-
-    return tempNumberOfPrimaryAntiMuonTrajectory;
-}
-
-int EventAnalysis::SetNumberOfPrimaryPionTrajectory()
+const std::vector<Cube::Handle<Cube::ReconObject>>& EventAnalysis::GetTimeOrderedObjects() const
 {
-    int tempNumberOfPrimaryPionTrajectory = 0;
-    for (Cube::Event::G4TrajectoryContainer::iterator g4Trajectory
-            = gEvent->G4Trajectories.begin();
-            g4Trajectory != gEvent->G4Trajectories.end();
-            ++g4Trajectory) 
-    {
-        Cube::Handle<Cube::G4Trajectory> gt = g4Trajectory->second; //trajectory
-        if (gt->GetParentId() == -1)
-        {
-            if (std::abs(gt->GetPDGCode()) == 211 || gt->GetPDGCode() == 111)
-            {
-                tempNumberOfPrimaryPionTrajectory++;
-            }
-        }
-    }
-    return tempNumberOfPrimaryPionTrajectory;
+    return this->mTimeOrderedObjects;
 }
 
 const int EventAnalysis::GetNumberOfPrimaryAntiMuonTrajectory() const
@@ -104,59 +164,100 @@ const int EventAnalysis::GetNumberOfPrimaryPionTrajectory() const
     return this->mNumberOfPrimaryPionTrajectory;
 }
 
-bool tSort(Cube::Handle<Cube::ReconObject> a, Cube::Handle<Cube::ReconObject> b)
+const ObjectSnapshot& EventAnalysis::GetSnapshot() const
 {
-    double aTime;
-    double bTime;
-    Cube::Handle<Cube::ReconTrack> tempTrackA = a;
-    Cube::Handle<Cube::ReconCluster> tempClusterA = a;
-    Cube::Handle<Cube::ReconTrack> tempTrackB = b;
-    Cube::Handle<Cube::ReconCluster> tempClusterB = b;
-    if (tempTrackA)
-    {
-        aTime = tempTrackA->GetPosition().T();
-    }
-    if (tempClusterA)
+    return this->mSnapshot;
+}
+
+const SpatialIndex& EventAnalysis::GetSpatialIndex() const
+{
+    if (!this->mSpatialIndexBuilt)
     {
-        aTime = tempClusterA->GetPosition().T();
+        this->mSpatialIndex.Build(this->mSnapshot);
+        this->mSpatialIndexBuilt = true;
     }
-    if (tempTrackB)
+    return this->mSpatialIndex;
+}
+
+void EventAnalysis::BuildSnapshot()
+{
+    this->mSnapshot.Clear();
+    if (!this->GetObjects())
     {
-        bTime = tempTrackB->GetPosition().T();
+        return;
     }
-    if (tempClusterB)
+
+    this->mSnapshot.Reserve(this->mObjects->size());
+    for (const auto& tempObject : *this->mObjects)
     {
-        bTime = tempClusterB->GetPosition().T();
+        int tempKind = ObjectSnapshot::kOther;
+        TLorentzVector tempPosition;
+        Cube::Handle<Cube::ReconTrack> tempTrack = tempObject;
+        if (tempTrack)
+        {
+            tempKind = ObjectSnapshot::kTrack;
+            tempPosition = tempTrack->GetPosition();
+        }
+        else
+        {
+            Cube::Handle<Cube::ReconCluster> tempCluster = tempObject;
+            if (tempCluster)
+            {
+                tempKind = ObjectSnapshot::kCluster;
+                tempPosition = tempCluster->GetPosition();
+            }
+        }
+        const int tempTrajectoryId = this->mTruthIndex.GetMainTrajectory(tempObject);
+        const TruthIndex::TrajectoryInfo* tempInfo = this->mTruthIndex.Find(tempTrajectoryId);
+        const int tempParentPdg = tempInfo ? this->mTruthIndex.GetTrajectoryPdg(tempInfo->parentId) : 0;
+        this->mSnapshot.Add(tempPosition, tempKind, tempTrajectoryId, tempInfo, tempParentPdg);
     }
-
-    return aTime < bTime;
 }
 
 void EventAnalysis::SortObjectsByTime()
 {
-    if (this->GetObjects())
+    this->mTimeOrderedObjects.clear();
+    this->mTimeOrder.clear();
+    if (!this->GetObjects())
     {
-        std::sort(this->mObjects->begin(), this->mObjects->end(), tSort);
+        return;
     }
-}
 
-void EventAnalysis::SetFirstObject()
-{
-    Cube::Handle<Cube::ReconObject> tempObject;
-    for (auto t : *mObjects)
+    const std::vector<double>& tempTimes = this->mSnapshot.GetT();
+    std::vector<TimeKey>& tempKeys = this->mTimeKeys;
+    tempKeys.clear();
+    tempKeys.reserve(tempTimes.size());
+    for (unsigned int i = 0; i < tempTimes.size(); ++i)
     {
-        if (GetPdg(t) == -13 || GetPdg(t) == 0 || std::abs(GetParentPdg(GetParentID(t))) == 13)
-        {
-            continue;
-        }
-        tempObject = t;
-        break;
+        tempKeys.push_back({tempTimes[i], i});
+    }
+
+    std::sort(tempKeys.begin(), tempKeys.end(),
+            [](const TimeKey& a, const TimeKey& b)
+            {
+                return a.time < b.time || (a.time == b.time && a.index < b.index);
+            });
+
+    this->mTimeOrderedObjects.reserve(tempKeys.size());
+    this->mTimeOrder.reserve(tempKeys.size());
+    for (const TimeKey& tempKey : tempKeys)
+    {
+        this->mTimeOrderedObjects.push_back((*this->mObjects)[tempKey.index]);
+        this->mTimeOrder.push_back(tempKey.index);
     }
-    if (!tempObject)
+}
+
+EventAnalysis::Status EventAnalysis::SetFirstObject()
+{
+    this->mSnapshot.SelectFirstObjectCandidates(this->mSelection);
+    const int tempIndex = this->mSnapshot.FindEarliest(this->mSelection);
+    if (tempIndex < 0)
     {
-        throw std::runtime_error("no first object candidate");
+        return kNoFirstObjectCandidate;
     }
-    this->mFirstObject = tempObject;
+    this->mFirstObject = (*this->mObjects)[tempIndex];
+    this->mFirstObjectIndex = tempIndex;
+    return kSuccess;
 }
 
 const Cube::Handle<Cube::ReconObject> EventAnalysis::GetFirstObject() const
@@ -164,122 +265,120 @@ const Cube::Handle<Cube::ReconObject> EventAnalysis::GetFirstObject() const
     return this->mFirstObject;
 }
 
-int EventAnalysis::SetNumberOfPrimaryAntiMuonObject()
+int EventAnalysis::GetFirstObjectIndex() const
 {
-    int tempNumberOfPrimaryAntiMuonObject = 0;
-    for (auto tempObject : *this->GetObjects())
+    return this->mFirstObjectIndex;
+}
+
+double EventAnalysis::GetFirstObjectDeltaT() const
+{
+    return this->mSnapshot.GetPosition(this->mFirstObjectIndex).T() - this->mVertex.T();
+}
+
+bool EventAnalysis::IsFirstObjectFromNeutron() const
+{
+    if (this->mFirstObjectIndex < 0)
     {
-        Cube::Handle<Cube::ReconTrack> tempTrack = tempObject;
-        if (tempTrack)
-        {
-            if (GetPdg(tempTrack) == -13 && GetParentID(tempTrack) == -1)
-            {
-                tempNumberOfPrimaryAntiMuonObject++;
-            }
-        }
+        return false;
     }
-    this->mNumberOfPrimaryAntiMuonObject = tempNumberOfPrimaryAntiMuonObject;
-    return tempNumberOfPrimaryAntiMuonObject;
+    return this->mSnapshot.GetPdg()[this->mFirstObjectIndex] == 2112
+        || (this->mSnapshot.GetAncestorFlags()[this->mFirstObjectIndex] & TruthIndex::kNeutronAncestor) != 0;
 }
 
-const int EventAnalysis::GetNumberOfPrimaryAntiMuonObject() const
+int EventAnalysis::CountObjectsNearVertex(double inRadius, int inKind) const
 {
-    return mNumberOfPrimaryAntiMuonObject;
+    return this->GetSpatialIndex().CountInRadius(this->mVertex.X(), this->mVertex.Y(), this->mVertex.Z(),
+            inRadius, inKind);
 }
 
-const int EventAnalysis::GetPdg(const Cube::Handle<Cube::ReconObject>& inObject) const
+double EventAnalysis::GetFirstObjectIsolation() const
 {
-    int tempPDGCode = 0;
-    Cube::Handle<Cube::ReconTrack> inTrack = inObject;
-    Cube::Handle<Cube::ReconCluster> inCluster = inObject;
-    if (inTrack)
+    const double tempInfinity = std::numeric_limits<double>::infinity();
+    if (this->mFirstObjectIndex < 0)
     {
-        for (Cube::Event::G4TrajectoryContainer::iterator g4Trajectory
-                = gEvent->G4Trajectories.begin();
-                g4Trajectory != gEvent->G4Trajectories.end();
-                ++g4Trajectory) 
-        {
-            if(g4Trajectory->first == Cube::Tool::MainTrajectory(*gEvent, *inTrack))
-            {
-                Cube::Handle<Cube::G4Trajectory> gt = g4Trajectory->second; //trajectory
-                tempPDGCode = gt->GetPDGCode();
-            }
-        }
+        return tempInfinity;
     }
-    if (inCluster)
+    // one query per event: a pass over the columns is cheaper than building the grid
+    const std::size_t tempSize = this->mSnapshot.GetSize();
+    const std::size_t tempFirst = this->mFirstObjectIndex;
+    const double tempX = this->mSnapshot.GetX()[tempFirst];
+    const double tempY = this->mSnapshot.GetY()[tempFirst];
+    const double tempZ = this->mSnapshot.GetZ()[tempFirst];
+    const double* __restrict x = this->mSnapshot.GetX().data();
+    const double* __restrict y = this->mSnapshot.GetY().data();
+    const double* __restrict z = this->mSnapshot.GetZ().data();
+    const int* __restrict kind = this->mSnapshot.GetKind().data();
+    double tempMinimum = tempInfinity;
+    for (std::size_t i = 0; i < tempSize; ++i)
     {
-        for (Cube::Event::G4TrajectoryContainer::iterator g4Trajectory
-                = gEvent->G4Trajectories.begin();
-                g4Trajectory != gEvent->G4Trajectories.end();
-                ++g4Trajectory) 
-        {
-            if(g4Trajectory->first == Cube::Tool::MainTrajectory(*gEvent, *inCluster))
-            {
-                Cube::Handle<Cube::G4Trajectory> gt = g4Trajectory->second; //trajectory
-                tempPDGCode = gt->GetPDGCode();
-            }
-        }
+        const double dx = x[i] - tempX;
+        const double dy = y[i] - tempY;
+        const double dz = z[i] - tempZ;
+        const double tempDistance = (kind[i] == ObjectSnapshot::kTrack && i != tempFirst)
+            ? dx * dx + dy * dy + dz * dz : tempInfinity;
+        tempMinimum = tempDistance < tempMinimum ? tempDistance : tempMinimum;
     }
-    return tempPDGCode;
+    return std::sqrt(tempMinimum);
 }
 
-const int EventAnalysis::GetParentID(const Cube::Handle<Cube::ReconObject>& inObject) const
+TLorentzVector EventAnalysis::GetObjectPosition(const Cube::Handle<Cube::ReconObject>& inObject)
 {
-    int tempParentId = 0;
-    Cube::Handle<Cube::ReconTrack> inTrack = inObject;
-    Cube::Handle<Cube::ReconCluster> inCluster = inObject;
-    if (inTrack)
+    Cube::Handle<Cube::ReconTrack> tempTrack = inObject;
+    if (tempTrack)
     {
-        for (Cube::Event::G4TrajectoryContainer::iterator g4Trajectory
-                = gEvent->G4Trajectories.begin();
-                g4Trajectory != gEvent->G4Trajectories.end();
-                ++g4Trajectory) 
-        {
-            if(g4Trajectory->first == Cube::Tool::MainTrajectory(*gEvent, *inTrack))
-            {
-                Cube::Handle<Cube::G4Trajectory> gt = g4Trajectory->second; //trajectory
-                tempParentId = gt->GetParentId();
-            }
-        }
+        return tempTrack->GetPosition();
     }
-    if (inCluster)
+    Cube::Handle<Cube::ReconCluster> tempCluster = inObject;
+    if (tempCluster)
     {
-        for (Cube::Event::G4TrajectoryContainer::iterator g4Trajectory
-                = gEvent->G4Trajectories.begin();
-                g4Trajectory != gEvent->G4Trajectories.end();
-                ++g4Trajectory) 
-        {
-            if(g4Trajectory->first == Cube::Tool::MainTrajectory(*gEvent, *inCluster))
-            {
-                Cube::Handle<Cube::G4Trajectory> gt = g4Trajectory->second; //trajectory
-                tempParentId = gt->GetParentId();
-            }
-        }
+        return tempCluster->GetPosition();
     }
-    return tempParentId;
+    return TLorentzVector();
+}
+
+int EventAnalysis::SetNumberOfPrimaryAntiMuonObject()
+{
+    this->mNumberOfPrimaryAntiMuonObject = this->mSnapshot.CountPrimaryTracks(-13);
+    return this->mNumberOfPrimaryAntiMuonObject;
+}
+
+const int EventAnalysis::GetNumberOfPrimaryAntiMuonObject() const
+{
+    return mNumberOfPrimaryAntiMuonObject;
+}
+
+const TruthIndex& EventAnalysis::GetTruthIndex() const
+{
+    return this->mTruthIndex;
 }
 
-void EventAnalysis::SetVertex()
+const int EventAnalysis::GetPdg(const Cube::Handle<Cube::ReconObject>& inObject) const
+{
+    return this->mTruthIndex.GetPdg(inObject);
+}
+
+const int EventAnalysis::GetParentID(const Cube::Handle<Cube::ReconObject>& inObject) const
+{
+    return this->mTruthIndex.GetParentID(inObject);
+}
+
+EventAnalysis::Status EventAnalysis::SetVertex()
 {
     TLorentzVector tempVertex;
-    for (auto tempObject : *this->GetObjects())
+    this->mSnapshot.SelectTracks(-13, this->mSelection);
+    const int tempIndex = this->mSnapshot.FindEarliest(this->mSelection);
+    if (tempIndex >= 0)
     {
-        Cube::Handle<Cube::ReconTrack> tempTrack = tempObject;
-        if (tempTrack)
-        {
-            Cube::Handle<Cube::TrackState> frontState = tempTrack->GetState();
-            if (GetPdg(tempTrack) == -13)
-            {
-                tempVertex = frontState->GetPosition();
-                break;
-            }
-        }
+        Cube::Handle<Cube::ReconTrack> tempTrack = (*this->mObjects)[tempIndex];
+        Cube::Handle<Cube::TrackState> frontState = tempTrack->GetState();
+        tempVertex = frontState->GetPosition();
     }
     if (tempVertex.X() == 0 && tempVertex.Y() == 0 && tempVertex.Z() == 0)
     {
-        throw std::runtime_error("no vertex candidate");
+        return kNoVertexCandidate;
     }
     this->mVertex = tempVertex;
+    return kSuccess;
 }
 
 const TLorentzVector& EventAnalysis::GetVertex() const
@@ -287,87 +386,67 @@ const TLorentzVector& EventAnalysis::GetVertex() const
     return this->mVertex;
 }
 
-const void EventAnalysis::ShowAllObjects() const
+void EventAnalysis::ShowObject(std::ostream& out, int inIndex) const
 {
-    std::cout << "number of tracks: " << this->mTrack.size() << std::endl;
-    std::cout << "number of clusters: " << this->mCluster.size() << std::endl;
-    for (auto tempObject : *this->GetObjects())
+    out << "(" << this->mSnapshot.GetX()[inIndex];
+    out << ", " << this->mSnapshot.GetY()[inIndex];
+    out << ", " << this->mSnapshot.GetZ()[inIndex];
+    out << ", " << this->mSnapshot.GetT()[inIndex];
+    out << ") , pdg: " << this->mSnapshot.GetPdg()[inIndex];
+    out << ", parentId: " << this->mSnapshot.GetParentId()[inIndex] << '\n';
+}
+
+const void EventAnalysis::ShowAllObjects(std::ostream& out) const
+{
+    out << "number of tracks: " << this->mTrack.size() << '\n';
+    out << "number of clusters: " << this->mCluster.size() << '\n';
+    for (unsigned int tempIndex : this->mTimeOrder)
     {
-        Cube::Handle<Cube::ReconTrack> tempTrack = tempObject;
-        if (tempTrack)
+        const int tempKind = this->mSnapshot.GetKind()[tempIndex];
+        if (tempKind == ObjectSnapshot::kTrack)
         {
-            std::cout << "track:   (" << tempTrack->GetPosition().X();
-            std::cout << ", " << tempTrack->GetPosition().Y();
-            std::cout << ", " << tempTrack->GetPosition().Z();
-            std::cout << ", " << tempTrack->GetPosition().T();
-            std::cout << ") , pdg: " << GetPdg(tempTrack);
-            std::cout << ", parentId: " << GetParentID(tempTrack) <<std::endl;
+            out << "track:   ";
+            this->ShowObject(out, tempIndex);
         }
-        Cube::Handle<Cube::ReconCluster> tempCluster = tempObject;
-        if (tempCluster)
+        else if (tempKind == ObjectSnapshot::kCluster)
         {
-            std::cout << "cluster: (" << tempCluster->GetPosition().X();
-            std::cout << ", " << tempCluster->GetPosition().Y();
-            std::cout << ", " << tempCluster->GetPosition().Z();
-            std::cout << ", " << tempCluster->GetPosition().T();
-            std::cout << ") , pdg: " << GetPdg(tempCluster);
-            std::cout << ", parentId: " << GetParentID(tempCluster) <<std::endl;
+            out << "cluster: ";
+            this->ShowObject(out, tempIndex);
         }
     }
 }
 
-const void EventAnalysis::ShowFirstObject() const
+const void EventAnalysis::ShowFirstObject(std::ostream& out) const
 {
-    Cube::Handle<Cube::ReconTrack> tempFirstTrack = this->GetFirstObject();
-    Cube::Handle<Cube::ReconCluster> tempFirstCluster= this->GetFirstObject();
-    if (tempFirstTrack)
+    const int tempKind = this->mFirstObjectIndex < 0
+        ? ObjectSnapshot::kOther : this->mSnapshot.GetKind()[this->mFirstObjectIndex];
+    if (tempKind == ObjectSnapshot::kTrack)
     {
-        std::cout << "first object, track:   (" << tempFirstTrack->GetPosition().X();
-        std::cout << ", " << tempFirstTrack->GetPosition().Y();
-        std::cout << ", " << tempFirstTrack->GetPosition().Z();
-        std::cout << ", " << tempFirstTrack->GetPosition().T();
-        std::cout << ") , pdg: " << GetPdg(tempFirstTrack);
-        std::cout << ", parentId: " << GetParentID(tempFirstTrack) <<std::endl;
+        out << "first object, track:   ";
+        this->ShowObject(out, this->mFirstObjectIndex);
     }
-    else if (tempFirstCluster)
+    else if (tempKind == ObjectSnapshot::kCluster)
     {
-        std::cout << "first object, cluster: (" << tempFirstCluster->GetPosition().X();
-        std::cout << ", " << tempFirstCluster->GetPosition().Y();
-        std::cout << ", " << tempFirstCluster->GetPosition().Z();
-        std::cout << ", " << tempFirstCluster->GetPosition().T();
-        std::cout << ") , pdg: " << GetPdg(tempFirstCluster);
-        std::cout << ", parentId: " << GetParentID(tempFirstCluster) <<std::endl;
+        out << "first object, cluster: ";
+        this->ShowObject(out, this->mFirstObjectIndex);
     }
     else
     {
-        std::cout << "no first object candidate" << std::endl;
+        out << "no first object candidate" << '\n';
     }
 }
 
-const void EventAnalysis::ShowVertex() const
+const void EventAnalysis::ShowVertex(std::ostream& out) const
 {
-    TLorentzVector vertex = this->GetVertex();
-    std::cout << "vertex: " << vertex.X()
+    const TLorentzVector& vertex = this->GetVertex();
+    out << "vertex: " << vertex.X()
         << ", " << vertex.Y()
         << ", " << vertex.Z()
         << ", " << vertex.T();
-    std::cout << std::endl;
+    out << '\n';
 }
 
 const int EventAnalysis::GetParentPdg(int inParentId) const
 {
-    int tempParentPdg = 0;
-    for (Cube::Event::G4TrajectoryContainer::iterator g4Trajectory
-            = gEvent->G4Trajectories.begin();
-            g4Trajectory != gEvent->G4Trajectories.end();
-            ++g4Trajectory) 
-    {
-        if(g4Trajectory->first == inParentId)
-        {
-            Cube::Handle<Cube::G4Trajectory> gt = g4Trajectory->second;
-            tempParentPdg = gt->GetPDGCode();
-            break;
-        }
-    }
-    return tempParentPdg;
+    return this->mTruthIndex.GetTrajectoryPdg(inParentId);
 }
@@ -9,29 +9,96 @@
 #include <CubeG4Trajectory.hxx>
 #include <ToolMainTrajectory.hxx>
 
-extern Cube::Event* gEvent;
+#include "TruthIndex.hxx"
+#include "ObjectSnapshot.hxx"
+#include "SpatialIndex.hxx"
+
+#include <iostream>
 
 /**
  * @brief EventAnalysis class
  * @details EventAnalysis has vector of Cube::Handle<Cube::ReconTrack>> 
  * and Cube::Handle<Cube::ReconCluster>. \n
- * It also has information of first object, vertex.
+ * It also has information of first object, vertex. \n
+ * All information is read from the event given to the constructor,
+ * so each thread can analyze its own event.
  * @date 2020-12-24
  */
 class EventAnalysis
 {
     public:
+        /**
+         * @brief status of construction and selection stages
+         * @details every status but kSuccess is the reason of an ordinary
+         * rejection of the event, the cut of RunStatistics it fails is
+         * not passed. Rejections are returned, not thrown.
+         */
+        enum Status : unsigned char
+        {
+            kSuccess = 0,
+            kNoObjectContainer,
+            kNoVertexCandidate,
+            kNoFirstObjectCandidate
+        };
+
         /**
          * @brief initializer
+         * @details nothing is computed here. \n
+         * Construction is staged: SetTruthCounters() is cheap and is
+         * enough for truth selection, CollectObjects() collects and sorts
+         * objects and should be called only for selected events.
+         * @param Cube::Event* inEvent: event to analyze, not owned
          */
-        EventAnalysis(Cube::Handle<Cube::AlgorithmResult> inResult)
-            : mNumberOfPrimaryPionTrajectory(SetNumberOfPrimaryPionTrajectory())
-              ,mNumberOfPrimaryAntiMuonTrajectory(SetNumberOfPrimaryAntiMuonTrajectory())
+        EventAnalysis(Cube::Event* inEvent)
+            : mEvent(inEvent)
         {
-            Add(inResult);
-            SortObjectsByTime();
         };
 
+        /**
+         * @brief reuse this analysis for another event
+         * @details all results of the previous event are cleared, but
+         * object vectors, sort keys and truth index keep their capacity,
+         * so one analysis per thread can be reused without reallocation.
+         * @param Cube::Event* inEvent: event to analyze, not owned
+         */
+        void Reset(Cube::Event* inEvent);
+
+        /**
+         * @brief set all truth counters of this event
+         * @details number of primary pions and primary anti muons are
+         * counted in a single pass over G4Trajectories.
+         * @return Status kSuccess
+         */
+        Status SetTruthCounters();
+
+        /**
+         * @brief collect and sort reconstructed objects of this event
+         * @details build truth index, add objects of inResult and
+         * sort them by time.
+         * @param Cube::Handle<Cube::AlgorithmResult> inResult: result
+         * which has object containers of this event
+         * @param const int* inMainTrajectories: optional precomputed main
+         * trajectory id of each object in GetObjects(), in container order
+         * @param int inNumberOfMainTrajectories: size of inMainTrajectories,
+         * -1 means unchecked. If it is not the number of objects (e.g.
+         * stale TruthSidecar) inMainTrajectories is ignored.
+         * @return Status kNoObjectContainer if inResult has no object container
+         */
+        Status CollectObjects(Cube::Handle<Cube::AlgorithmResult> inResult,
+                const int* inMainTrajectories = NULL, int inNumberOfMainTrajectories = -1);
+
+        /**
+         * @brief get message of status
+         * @return const char*
+         */
+        static const char* GetStatusMessage(Status inStatus);
+
+        /**
+         * @brief get event of this analysis
+         * @return Cube::Event*
+         */
+        Cube::Event* GetEvent() const;
+
         /**
          * @brief get vector of tracks in this event
          * @return std::vector<Cube::Handle<Cube::ReconTrack>>: vector of tracks
@@ -52,6 +119,30 @@ class EventAnalysis
          */
         const Cube::Handle<Cube::ReconObjectContainer>& GetObjects() const;
 
+        /**
+         * @brief get objects in this event ordered by time
+         * @details the ReconObjectContainer of the event is not reordered,
+         * this is a separate view of the same objects.
+         * @return std::vector<Cube::Handle<Cube::ReconObject>>
+         */
+        const std::vector<Cube::Handle<Cube::ReconObject>>& GetTimeOrderedObjects() const;
+
+        /**
+         * @brief get snapshot of objects in this event
+         * @details row i is object i of GetObjects(), built by CollectObjects().
+         * @return const ObjectSnapshot&
+         */
+        const ObjectSnapshot& GetSnapshot() const;
+
+        /**
+         * @brief get spatial index of objects in this event
+         * @details tracks and clusters of the snapshot. The index is built
+         * by the first query of an event, so paths which never query it
+         * (e.g. sidecar and event store filling) do not pay for it.
+         * @return const SpatialIndex&
+         */
+        const SpatialIndex& GetSpatialIndex() const;
+
         /**
          * @brief set number of primary anti muon object
          * @details count how many primary anti muons are in this event 
@@ -84,6 +175,12 @@ class EventAnalysis
          */
         const int GetNumberOfPrimaryPionTrajectory() const;
 
+        /**
+         * @brief get truth index of this event
+         * @return const TruthIndex&
+         */
+        const TruthIndex& GetTruthIndex() const;
+
         /**
          * @brief get pdg code of object
          * @param const Cube::Handle<Cube::ReconObject>& inObject: input object
@@ -105,8 +202,9 @@ class EventAnalysis
         /**
          * @brief set interaction vertex
          * @details vertex is TLorentzVector, earliest primary muon track's front point
+         * @return Status kNoVertexCandidate if there is no such track, vertex is not changed
          */
-        void SetVertex();
+        Status SetVertex();
 
         /**
          * @brief get interaction vertex
@@ -116,9 +214,12 @@ class EventAnalysis
         /**
          * @brief set first object in time
          * @detials The first object should not be muon or muon induced \n
-         * (assume that muon PID is very good)
+         * (assume that muon PID is very good) \n
+         * Muon induced means any descendant of a muon, not only children.
+         * @return Status kNoFirstObjectCandidate if there is no such object,
+         * first object is not changed
          */
-        void SetFirstObject();
+        Status SetFirstObject();
 
         /**
          * @brief get first object in time
@@ -126,34 +227,113 @@ class EventAnalysis
          */
         const Cube::Handle<Cube::ReconObject> GetFirstObject() const;
 
+        /**
+         * @brief get row of first object in snapshot
+         * @return int -1 if first object is not set
+         */
+        int GetFirstObjectIndex() const;
+
+        /**
+         * @brief get time difference of first object and vertex
+         * @details first object time - vertex time. \n
+         * vertex and first object should be already set.
+         * @return double delta T
+         */
+        double GetFirstObjectDeltaT() const;
+
+        /**
+         * @brief check if first object comes from neutron
+         * @details true if the main trajectory of the first object is a
+         * neutron or descends from a neutron.
+         */
+        bool IsFirstObjectFromNeutron() const;
+
+        /**
+         * @brief count objects near interaction vertex
+         * @details vertex should be already set.
+         * @param double inRadius: distance from vertex
+         * @param int inKind: ObjectSnapshot::Kind of objects, -1 means any
+         * @return int number of tracks or clusters within inRadius
+         */
+        int CountObjectsNearVertex(double inRadius, int inKind = -1) const;
+
+        /**
+         * @brief get distance from first object to the nearest other track
+         * @details first object should be already set. This is a single
+         * query per event, so it is a pass over the snapshot, the spatial
+         * index is not built.
+         * @return double infinity if there is no other track
+         */
+        double GetFirstObjectIsolation() const;
+
+        /**
+         * @brief get position of track or cluster
+         * @return TLorentzVector (x, y, z, t), zero if object is neither
+         * track nor cluster
+         */
+        static TLorentzVector GetObjectPosition(const Cube::Handle<Cube::ReconObject>& inObject);
+
         /**
          * @brief show all object information in this event
-         * @details informations: (x, y, z, t), pdg, parentId
+         * @details informations: (x, y, z, t), pdg, parentId, read from
+         * the snapshot in time order. Lines are not flushed.
+         * @param std::ostream& out: output stream
          */
-        const void ShowAllObjects() const;
+        const void ShowAllObjects(std::ostream& out = std::cout) const;
 
         /**
          * @brief show first object information in this event
          * @details informations: (x, y, z, t), pdg, parentId
+         * @param std::ostream& out: output stream
          */
-        const void ShowFirstObject() const;
+        const void ShowFirstObject(std::ostream& out = std::cout) const;
 
         /**
          * @brief show interaction vertex information of this event
          * @details informations: (x, y, z, t)
+         * @param std::ostream& out: output stream
          */
-        const void ShowVertex() const;
+        const void ShowVertex(std::ostream& out = std::cout) const;
 
     private:
+        /**
+         * @brief event of this analysis
+         */
+        Cube::Event* mEvent = NULL;
+
+        /**
+         * @brief sort key of object
+         * @details time is read from snapshot, index is position in mObjects.
+         */
+        struct TimeKey
+        {
+            double time;
+            unsigned int index;
+        };
+
+        /**
+         * @brief fill snapshot of objects in this event
+         * @details each object is cast and matched to truth once.
+         */
+        void BuildSnapshot();
+
         /**
          * @brief sort object in this event by time
+         * @details fill mTimeOrderedObjects, mObjects is not modified. \n
+         * Objects which are neither track nor cluster are placed last.
          */
         void SortObjectsByTime();
 
+        /**
+         * @brief show (x, y, z, t), pdg, parentId of snapshot row
+         */
+        void ShowObject(std::ostream& out, int inIndex) const;
+
         /**
          * @brief add reconstructed object from data file to this event
+         * @return Status kNoObjectContainer if inResult has no object container
          */
-        void Add(Cube::Handle<Cube::AlgorithmResult> inResult);
+        Status Add(Cube::Handle<Cube::AlgorithmResult> inResult);
 
         /**
          * @brief vector of tracks of this event
@@ -171,21 +351,39 @@ class EventAnalysis
         Cube::Handle<Cube::ReconObjectContainer> mObjects;
 
         /**
-         * @brief set number of primary anti muon
-         * @details count how many primary anti muons are in this event 
-         * based on true information.
-         * @return int number of primary anti muon
+         * @brief objects in this event ordered by time
          */
-        int SetNumberOfPrimaryAntiMuonTrajectory();
+        std::vector<Cube::Handle<Cube::ReconObject>> mTimeOrderedObjects;
 
         /**
-         * @brief set number of primary pion
-         * @details count how many primary pions are in this event 
-         * based on true information. \n
-         * The pion includes pi+- pi0
-         * @return int number of primary pion
+         * @brief snapshot rows in time order
          */
-        int SetNumberOfPrimaryPionTrajectory();
+        std::vector<unsigned int> mTimeOrder;
+
+        /**
+         * @brief truth index of this event
+         */
+        TruthIndex mTruthIndex;
+
+        /**
+         * @brief snapshot of objects in this event
+         */
+        ObjectSnapshot mSnapshot;
+
+        /**
+         * @brief spatial index of snapshot rows, built on first query
+         */
+        mutable SpatialIndex mSpatialIndex;
+
+        /**
+         * @brief mSpatialIndex is built for this event
+         */
+        mutable bool mSpatialIndexBuilt = false;
+
+        /**
+         * @brief selection mask of snapshot kernels, reused between calls
+         */
+        std::vector<unsigned char> mSelection;
 
         /**
          * @brief number of primary anti muon (beasd on true information)
@@ -201,7 +399,12 @@ class EventAnalysis
          * @brief number of primary pion (beasd on true information)
          */
         int mNumberOfPrimaryPionTrajectory = 0;
-        
+
+        /**
+         * @brief sort keys of SortObjectsByTime(), reused between events
+         */
+        std::vector<TimeKey> mTimeKeys;
+
         /**
          * @brief interaction vertex
          */
@@ -211,6 +414,11 @@ class EventAnalysis
          * @brief first object in time
          */
         Cube::Handle<Cube::ReconObject> mFirstObject;
+
+        /**
+         * @brief row of first object in snapshot
+         */
+        int mFirstObjectIndex = -1;
 };
 
 #endif
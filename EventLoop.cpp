@@ -0,0 +1,904 @@
+#include "EventLoop.hxx"
+#include "SkimIndex.hxx"
+
+#include <TChain.h>
+#include <TChainElement.h>
+#include <TEnv.h>
+#include <TFile.h>
+#include <TObjArray.h>
+#include <TROOT.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+namespace
+{
+    /**
+     * @brief bytes of worker output handed to the logger at once
+     */
+    const std::streamoff kLoggerBufferSize = 64 * 1024;
+
+    /**
+     * @brief maximum number of entries of a block in ordered mode
+     * @details output of a block is kept until all its workers are done.
+     */
+    const Long64_t kOrderedBlockSize = 10000;
+}
+
+EventLoop::EventLoop(const std::vector<std::string>& inFileNames, int inNumberOfThreads, bool inOrdered)
+    : mFileNames(inFileNames)
+      ,mNumberOfThreads(inNumberOfThreads)
+      ,mOrdered(inOrdered)
+      ,mDeltaTNeutron(std::make_unique<TH1F> ("","#delta T, neutron",100,-10,10))
+      ,mDeltaTOther(std::make_unique<TH1F> ("","#delta T, other",100,-10,10))
+{
+    if (this->mNumberOfThreads <= 0)
+    {
+        this->mNumberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+TH1F* EventLoop::GetDeltaTNeutron() const
+{
+    return this->mDeltaTNeutron.get();
+}
+
+TH1F* EventLoop::GetDeltaTOther() const
+{
+    return this->mDeltaTOther.get();
+}
+
+void EventLoop::SetReadCache(Long64_t inCacheSize, Int_t inLearnEntries)
+{
+    this->mCacheSize = inCacheSize;
+    this->mLearnEntries = inLearnEntries;
+}
+
+void EventLoop::SetPrefetch(bool inPrefetch)
+{
+    this->mPrefetch = inPrefetch;
+}
+
+void EventLoop::SetBranches(const std::vector<std::string>& inBranches)
+{
+    this->mBranches = inBranches;
+}
+
+void EventLoop::SetUpReading() const
+{
+    if (this->mPrefetch)
+    {
+        gEnv->SetValue("TFile.AsyncPrefetching", 1);
+    }
+}
+
+std::unique_ptr<TChain> EventLoop::MakeChain(bool inReader) const
+{
+    std::unique_ptr<TChain> tempChain = std::make_unique<TChain> ("CubeEvents");
+    for (const std::string& tempFileName : this->mFileNames)
+    {
+        tempChain->Add(tempFileName.c_str());
+    }
+    if (!inReader)
+    {
+        return tempChain;
+    }
+
+    if (!this->mBranches.empty())
+    {
+        tempChain->SetBranchStatus("*", false);
+        for (const std::string& tempBranch : this->mBranches)
+        {
+            tempChain->SetBranchStatus(tempBranch.c_str(), true);
+        }
+    }
+    if (this->mCacheSize > 0)
+    {
+        tempChain->SetCacheSize(this->mCacheSize);
+        if (this->mBranches.empty())
+        {
+            tempChain->AddBranchToCache("*", true);
+        }
+        else
+        {
+            for (const std::string& tempBranch : this->mBranches)
+            {
+                tempChain->AddBranchToCache(tempBranch.c_str(), true);
+            }
+        }
+        tempChain->SetCacheLearnEntries(this->mLearnEntries);
+    }
+    return tempChain;
+}
+
+std::vector<EventLoop::InputFile> EventLoop::ListInputFiles(TChain& inChain)
+{
+    std::vector<InputFile> tempInputFiles;
+    TObjArray* tempFiles = inChain.GetListOfFiles();
+    if (!tempFiles)
+    {
+        return tempInputFiles;
+    }
+    Long64_t tempOffset = 0;
+    for (int i = 0; i < tempFiles->GetEntries(); ++i)
+    {
+        TChainElement* tempElement = static_cast<TChainElement*>(tempFiles->At(i));
+        InputFile tempInputFile;
+        tempInputFile.name = tempElement->GetTitle();
+        tempInputFile.offset = tempOffset;
+        tempInputFile.entries = tempElement->GetEntries();
+        tempOffset += tempInputFile.entries;
+        tempInputFiles.push_back(tempInputFile);
+    }
+    return tempInputFiles;
+}
+
+void EventLoop::SetSummaryFile(const std::string& inFileName)
+{
+    this->mSummaryFileName = inFileName;
+}
+
+void EventLoop::SetQuiet(bool inQuiet)
+{
+    this->mVerbosity = inQuiet ? Logger::kError : Logger::kObjects;
+}
+
+void EventLoop::SetVerbosity(int inVerbosity)
+{
+    this->mVerbosity = inVerbosity;
+}
+
+void EventLoop::SetSkim(bool inSkim)
+{
+    this->mSkim = inSkim;
+}
+
+void EventLoop::SetSlimFile(const std::string& inFileName)
+{
+    this->mSlimFileName = inFileName;
+}
+
+const RunStatistics& EventLoop::GetStatistics() const
+{
+    return this->mStatistics;
+}
+
+void EventLoop::SetStatisticsFile(const std::string& inFileName)
+{
+    this->mStatisticsFileName = inFileName;
+}
+
+void EventLoop::SetEntryRange(Long64_t inFirst, Long64_t inLast)
+{
+    this->mFirstEntry = inFirst;
+    this->mLastEntry = inLast;
+}
+
+void EventLoop::SetShard(int inShard, int inNumberOfShards)
+{
+    this->mShard = inShard;
+    this->mNumberOfShards = std::max(1, inNumberOfShards);
+}
+
+void EventLoop::SetCheckpoint(const std::string& inFileName, Long64_t inInterval)
+{
+    this->mCheckpointFileName = inFileName;
+    this->mCheckpointInterval = inInterval;
+}
+
+void EventLoop::SetTruthSidecar(bool inTruthSidecar)
+{
+    this->mTruthSidecar = inTruthSidecar;
+}
+
+bool EventLoop::MakeTruthSidecars()
+{
+    this->SetUpReading();
+    std::unique_ptr<TChain> tempCubeReconTree = this->MakeChain(false);
+    if (!tempCubeReconTree || this->mFileNames.empty())
+    {
+        std::cout << "Missing the event tree" << std::endl;
+        return false;
+    }
+    tempCubeReconTree->GetEntries();
+    const std::vector<InputFile> tempInputFiles = ListInputFiles(*tempCubeReconTree);
+
+    const int tempNumberOfWorkers = std::max(1, std::min(this->mNumberOfThreads, static_cast<int>(tempInputFiles.size())));
+    if (tempNumberOfWorkers > 1)
+    {
+        ROOT::EnableThreadSafety();
+    }
+    std::atomic<std::size_t> tempNextFile(0);
+    std::vector<char> tempSaved(tempInputFiles.size(), 0);
+    auto tempMake = [&]()
+    {
+        for (std::size_t f = tempNextFile++; f < tempInputFiles.size(); f = tempNextFile++)
+        {
+            tempSaved[f] = this->MakeTruthSidecar(tempInputFiles[f]);
+        }
+    };
+    std::vector<std::thread> tempThreads;
+    for (int w = 1; w < tempNumberOfWorkers; ++w)
+    {
+        tempThreads.emplace_back(tempMake);
+    }
+    tempMake();
+    for (std::thread& tempThread : tempThreads)
+    {
+        tempThread.join();
+    }
+    bool tempAllSaved = true;
+    for (std::size_t f = 0; f < tempInputFiles.size(); ++f)
+    {
+        if (!tempSaved[f])
+        {
+            std::cout << "cannot write truth sidecar of " << tempInputFiles[f].name << std::endl;
+            tempAllSaved = false;
+        }
+    }
+    std::cout << "truth sidecar of " << tempInputFiles.size() << " input file(s)"
+        << (tempAllSaved ? " written" : " not complete") << std::endl;
+    return tempAllSaved;
+}
+
+bool EventLoop::MakeTruthSidecar(const InputFile& inInputFile) const
+{
+    TChain tempChain("CubeEvents");
+    tempChain.Add(inInputFile.name.c_str());
+    if (this->mCacheSize > 0)
+    {
+        tempChain.SetCacheSize(this->mCacheSize);
+        tempChain.AddBranchToCache("*", true);
+    }
+    Cube::Event* tempEvent = NULL;
+    tempChain.SetBranchAddress("Event", &tempEvent);
+
+    TruthSidecar tempSidecar(inInputFile.name);
+    {
+        EventAnalysis tempEventAnalysis(tempEvent);
+        for (Long64_t i = 0; i < inInputFile.entries; ++i)
+        {
+            tempChain.GetEntry(i);
+            tempEventAnalysis.Reset(tempEvent);
+            Cube::Handle<Cube::AlgorithmResult> topResult(tempEvent, false);
+            // no object container: entry is added without objects
+            tempEventAnalysis.CollectObjects(topResult);
+            tempSidecar.AddEntry(tempEventAnalysis.GetSnapshot());
+        }
+    }
+    tempChain.ResetBranchAddresses();
+    delete tempEvent;
+
+    return tempSidecar.Save(inInputFile.entries);
+}
+
+void EventLoop::GetEntryRange(Long64_t inNumberOfEntries, Long64_t& outFirst, Long64_t& outLast) const
+{
+    // [first, last) of the range, then one shard of it
+    const Long64_t tempRangeFirst = std::min(std::max<Long64_t>(0, this->mFirstEntry), inNumberOfEntries);
+    const Long64_t tempRangeLast = std::max(tempRangeFirst, this->mLastEntry < 0
+            ? inNumberOfEntries : std::min(this->mLastEntry, inNumberOfEntries));
+    const Long64_t tempRangeSize = tempRangeLast - tempRangeFirst;
+    outFirst = tempRangeFirst + tempRangeSize * this->mShard / this->mNumberOfShards;
+    outLast = tempRangeFirst + tempRangeSize * (this->mShard + 1) / this->mNumberOfShards;
+}
+
+void EventLoop::OpenTruthSidecars(const std::vector<InputFile>& inInputFiles)
+{
+    this->mTruthSidecars.clear();
+    if (!this->mTruthSidecar)
+    {
+        return;
+    }
+    int tempNumberOfSidecars = 0;
+    for (const InputFile& tempInputFile : inInputFiles)
+    {
+        std::unique_ptr<TruthSidecar> tempSidecar = std::make_unique<TruthSidecar> (tempInputFile.name);
+        if (tempSidecar->Open(tempInputFile.entries))
+        {
+            tempNumberOfSidecars++;
+        }
+        else
+        {
+            tempSidecar.reset();
+        }
+        this->mTruthSidecars.push_back(std::move(tempSidecar));
+    }
+    std::cout << "truth sidecar of " << tempNumberOfSidecars << "/" << inInputFiles.size()
+        << " input file(s)" << std::endl;
+}
+
+void EventLoop::FindMainTrajectories(const TChain& inChain, Long64_t inEntry,
+        const int*& outMainTrajectories, int& outNumberOfMainTrajectories) const
+{
+    const int tempTreeNumber = inChain.GetTreeNumber();
+    if (tempTreeNumber < 0 || static_cast<std::size_t>(tempTreeNumber) >= this->mTruthSidecars.size()
+            || !this->mTruthSidecars[tempTreeNumber])
+    {
+        return;
+    }
+    const TruthSidecar& tempSidecar = *this->mTruthSidecars[tempTreeNumber];
+    const Long64_t tempLocalEntry = inEntry - inChain.GetChainOffset();
+    outMainTrajectories = tempSidecar.GetMainTrajectories(tempLocalEntry);
+    outNumberOfMainTrajectories = tempSidecar.GetNumberOfObjects(tempLocalEntry);
+}
+
+bool EventLoop::FillEventStore(EventStore& outStore)
+{
+    outStore.Clear();
+    this->SetUpReading();
+    std::unique_ptr<TChain> tempCubeReconTree = this->MakeChain(false);
+    if (!tempCubeReconTree || this->mFileNames.empty())
+    {
+        std::cout << "Missing the event tree" << std::endl;
+        return false;
+    }
+    const Long64_t tempNumberOfEntries = tempCubeReconTree->GetEntries();
+    Long64_t tempFirstEntry = 0;
+    Long64_t tempLastEntry = 0;
+    this->GetEntryRange(tempNumberOfEntries, tempFirstEntry, tempLastEntry);
+    this->OpenTruthSidecars(ListInputFiles(*tempCubeReconTree));
+
+    const int tempNumberOfWorkers = static_cast<int>(std::max<Long64_t>(1,
+                std::min<Long64_t>(this->mNumberOfThreads, tempLastEntry - tempFirstEntry)));
+    if (tempNumberOfWorkers > 1)
+    {
+        ROOT::EnableThreadSafety();
+    }
+    std::vector<EventStore> tempStores(tempNumberOfWorkers);
+    std::vector<std::thread> tempThreads;
+    for (int w = 0; w < tempNumberOfWorkers; ++w)
+    {
+        const Long64_t tempFirst = tempFirstEntry + (tempLastEntry - tempFirstEntry) * w / tempNumberOfWorkers;
+        const Long64_t tempLast = tempFirstEntry + (tempLastEntry - tempFirstEntry) * (w + 1) / tempNumberOfWorkers;
+        tempThreads.emplace_back(&EventLoop::FillEventStoreRange, this, tempFirst, tempLast, std::ref(tempStores[w]));
+    }
+    for (std::thread& tempThread : tempThreads)
+    {
+        tempThread.join();
+    }
+    for (const EventStore& tempStore : tempStores)
+    {
+        outStore.Append(tempStore);
+    }
+    this->mTruthSidecars.clear();
+    std::cout << "event store: " << outStore.GetNumberOfEvents() << " events, "
+        << outStore.GetNumberOfObjects() << " objects, "
+        << outStore.GetMemorySize() / (1024. * 1024.) << " MB" << std::endl;
+    return true;
+}
+
+void EventLoop::FillEventStoreRange(Long64_t inFirst, Long64_t inLast, EventStore& outStore)
+{
+    std::unique_ptr<TChain> tempCubeReconTree = this->MakeChain(true);
+    Cube::Event* tempEvent = NULL;
+    tempCubeReconTree->SetBranchAddress("Event", &tempEvent);
+    if (this->mCacheSize > 0 && inFirst < inLast)
+    {
+        tempCubeReconTree->SetCacheEntryRange(inFirst, inLast);
+    }
+    {
+        EventAnalysis tempEventAnalysis(tempEvent);
+        for (Long64_t i = inFirst; i < inLast; ++i)
+        {
+            tempCubeReconTree->GetEntry(i);
+            const int* tempMainTrajectories = NULL;
+            int tempNumberOfMainTrajectories = -1;
+            this->FindMainTrajectories(*tempCubeReconTree, i, tempMainTrajectories, tempNumberOfMainTrajectories);
+
+            // every entry is kept, cuts are applied by EventStore::Select
+            tempEventAnalysis.Reset(tempEvent);
+            tempEventAnalysis.SetTruthCounters();
+            Cube::Handle<Cube::AlgorithmResult> topResult(tempEvent, false);
+            const bool tempHasObjects = tempEventAnalysis.CollectObjects(topResult,
+                    tempMainTrajectories, tempNumberOfMainTrajectories) == EventAnalysis::kSuccess;
+            bool tempHasVertex = false;
+            if (tempHasObjects)
+            {
+                tempEventAnalysis.SetNumberOfPrimaryAntiMuonObject();
+                tempHasVertex = tempEventAnalysis.SetVertex() == EventAnalysis::kSuccess;
+            }
+            outStore.Add(tempEventAnalysis, i, tempHasObjects, tempHasVertex);
+        }
+    }
+    tempCubeReconTree->ResetBranchAddresses();
+    delete tempEvent;
+}
+
+bool EventLoop::Run()
+{
+    std::chrono::steady_clock::time_point tempStartTime = std::chrono::steady_clock::now();
+    const Long64_t tempStartFileBytes = TFile::GetFileBytesRead();
+
+    this->SetUpReading();
+    std::unique_ptr<TChain> tempCubeReconTree = this->MakeChain(false);
+
+    if (!tempCubeReconTree || this->mFileNames.empty())
+    {
+        std::cout << "Missing the event tree" << std::endl;
+        return false;
+    }
+
+    const Long64_t tempNumberOfEntries = tempCubeReconTree->GetEntries();
+    std::cout<<"total number of events : "<<tempNumberOfEntries<<std::endl;
+
+    Long64_t tempFirstEntry = 0;
+    Long64_t tempLastEntry = 0;
+    this->GetEntryRange(tempNumberOfEntries, tempFirstEntry, tempLastEntry);
+    const bool tempFullRange = (tempFirstEntry == 0 && tempLastEntry == tempNumberOfEntries);
+    if (!tempFullRange)
+    {
+        std::cout << "entries of this run : [" << tempFirstEntry << ", " << tempLastEntry << ")";
+        if (this->mNumberOfShards > 1)
+        {
+            std::cout << ", shard " << this->mShard << "/" << this->mNumberOfShards;
+        }
+        std::cout << std::endl;
+    }
+
+    const std::vector<InputFile> tempInputFiles = ListInputFiles(*tempCubeReconTree);
+    std::vector<Long64_t> tempSkimEntries;
+    const std::vector<Long64_t>* tempEntryList = NULL;
+    if (this->mSkim && !tempInputFiles.empty())
+    {
+        bool tempSkimLoaded = true;
+        for (const InputFile& tempInputFile : tempInputFiles)
+        {
+            SkimIndex tempSkimIndex(tempInputFile.name);
+            if (!tempSkimIndex.Load(tempInputFile.entries))
+            {
+                tempSkimLoaded = false;
+                break;
+            }
+            for (Long64_t tempEntry : tempSkimIndex.GetEntries())
+            {
+                if (tempEntry + tempInputFile.offset >= tempFirstEntry
+                        && tempEntry + tempInputFile.offset < tempLastEntry)
+                {
+                    tempSkimEntries.push_back(tempInputFile.offset + tempEntry);
+                }
+            }
+        }
+        if (tempSkimLoaded)
+        {
+            tempEntryList = &tempSkimEntries;
+            std::cout << "skim index of " << tempInputFiles.size() << " input file(s)"
+                << ", selected entries : " << tempEntryList->size() << std::endl;
+        }
+        else
+        {
+            tempSkimEntries.clear();
+        }
+    }
+    this->OpenTruthSidecars(tempInputFiles);
+    // positions are entries, or positions in the skim entry list
+    Long64_t tempFirstPosition = tempEntryList ? 0 : tempFirstEntry;
+    const Long64_t tempLastPosition = tempEntryList ? tempEntryList->size() : tempLastEntry;
+
+    const int tempNumberOfWorkers = static_cast<int>(std::max<Long64_t>(1,
+                std::min<Long64_t>(this->mNumberOfThreads, tempLastPosition - tempFirstPosition)));
+    if (tempNumberOfWorkers > 1)
+    {
+        ROOT::EnableThreadSafety();
+    }
+
+    std::vector<Long64_t> tempSelected;
+    HistogramBuffer tempDeltaTNeutron(*this->mDeltaTNeutron);
+    HistogramBuffer tempDeltaTOther(*this->mDeltaTOther);
+
+    std::unique_ptr<Checkpoint> tempCheckpoint;
+    CheckpointState tempState;
+    if (!this->mCheckpointFileName.empty())
+    {
+        tempCheckpoint = std::make_unique<Checkpoint> (this->mCheckpointFileName);
+        for (const InputFile& tempInputFile : tempInputFiles)
+        {
+            tempState.inputFiles.push_back(tempInputFile.name);
+        }
+        tempState.numberOfEntries = tempNumberOfEntries;
+        tempState.first = tempFirstEntry;
+        tempState.last = tempLastEntry;
+
+        CheckpointState tempSavedState;
+        std::vector<Long64_t> tempSavedSelected;
+        const bool tempLoaded = tempCheckpoint->Load(tempSavedState, tempSavedSelected);
+        if (tempLoaded
+                && Checkpoint::IsSameRun(tempSavedState, tempState)
+                && this->Resume(tempSavedState, tempDeltaTNeutron, tempDeltaTOther))
+        {
+            tempSelected = std::move(tempSavedSelected);
+            tempFirstPosition = tempEntryList
+                ? std::lower_bound(tempEntryList->begin(), tempEntryList->end(), tempSavedState.next) - tempEntryList->begin()
+                : tempSavedState.next;
+            std::cout << "resume from checkpoint " << tempCheckpoint->GetFileName()
+                << ", next entry : " << tempSavedState.next << std::endl;
+        }
+        else if (tempLoaded)
+        {
+            // checkpoint of another run, this run starts a new one
+            tempCheckpoint->Remove();
+        }
+    }
+    if (!this->mSummaryFileName.empty() && !this->mSummaryWriter)
+    {
+        this->mSummaryWriter = std::make_unique<SummaryWriter> (this->mSummaryFileName);
+        if (!this->mSummaryWriter->IsOpen())
+        {
+            std::cout << "cannot open summary file " << this->mSummaryFileName << std::endl;
+            this->mSummaryWriter.reset();
+            this->mTruthSidecars.clear();
+            return false;
+        }
+    }
+
+    // in ordered mode summaries are kept until all workers of a block are done,
+    // blocks are bounded below
+    const size_t tempSummaryBatchSize = (this->mOrdered && tempNumberOfWorkers > 1) ? 0 : 1024;
+
+    std::vector<Worker> tempWorkers(tempNumberOfWorkers);
+    for (Worker& tempWorker : tempWorkers)
+    {
+        tempWorker.deltaTNeutron = std::make_unique<HistogramBuffer> (*this->mDeltaTNeutron);
+        tempWorker.deltaTOther = std::make_unique<HistogramBuffer> (*this->mDeltaTOther);
+        if (this->mSummaryWriter)
+        {
+            tempWorker.summary = std::make_unique<SummaryBuffer> (this->mSummaryWriter.get(), tempSummaryBatchSize);
+        }
+    }
+
+    this->mLogger = std::make_unique<Logger> (std::cout, this->mVerbosity);
+
+    // without checkpoint the whole range is one block, but ordered output and
+    // summaries of several workers are kept in memory per block, so blocks are bounded
+    const Long64_t tempCheckpointInterval = (tempCheckpoint && this->mCheckpointInterval > 0)
+        ? this->mCheckpointInterval : 0;
+    Long64_t tempBlockSize = tempCheckpointInterval > 0
+        ? tempCheckpointInterval : std::max<Long64_t>(1, tempLastPosition - tempFirstPosition);
+    if (this->mOrdered && tempNumberOfWorkers > 1
+            && (this->mVerbosity >= Logger::kEvent || this->mSummaryWriter))
+    {
+        tempBlockSize = std::min(tempBlockSize, kOrderedBlockSize);
+    }
+    Long64_t tempNextCheckpoint = tempFirstPosition + tempCheckpointInterval;
+    for (Long64_t tempBlockFirst = tempFirstPosition; tempBlockFirst < tempLastPosition; tempBlockFirst += tempBlockSize)
+    {
+        const Long64_t tempBlockLast = std::min(tempBlockFirst + tempBlockSize, tempLastPosition);
+        for (int w = 0; w < tempNumberOfWorkers; ++w)
+        {
+            tempWorkers[w].first = tempBlockFirst + (tempBlockLast - tempBlockFirst) * w / tempNumberOfWorkers;
+            tempWorkers[w].last = tempBlockFirst + (tempBlockLast - tempBlockFirst) * (w + 1) / tempNumberOfWorkers;
+        }
+
+        if (tempNumberOfWorkers == 1)
+        {
+            this->Process(tempWorkers.front(), tempEntryList);
+        }
+        else
+        {
+            std::vector<std::thread> tempThreads;
+            for (Worker& tempWorker : tempWorkers)
+            {
+                tempThreads.emplace_back(&EventLoop::Process, this, std::ref(tempWorker), tempEntryList);
+            }
+            for (std::thread& tempThread : tempThreads)
+            {
+                tempThread.join();
+            }
+        }
+        this->CollectWorkers(tempWorkers, tempDeltaTNeutron, tempDeltaTOther, tempSelected);
+
+        if (tempCheckpoint && (tempBlockLast >= tempNextCheckpoint || tempBlockLast >= tempLastPosition))
+        {
+            tempNextCheckpoint = tempBlockLast + tempCheckpointInterval;
+            if (this->mSummaryWriter)
+            {
+                this->mSummaryWriter->AutoSave();
+            }
+            tempState.next = tempBlockLast >= tempLastPosition ? tempLastEntry
+                : (tempEntryList ? (*tempEntryList)[tempBlockLast] : tempBlockLast);
+            tempState.numberOfSummaryRows = this->mSummaryWriter ? this->mSummaryWriter->GetNumberOfRows() : 0;
+            tempState.deltaTNeutron = tempDeltaTNeutron.GetContents();
+            tempState.deltaTOther = tempDeltaTOther.GetContents();
+            tempState.passed.clear();
+            for (int i = 0; i < RunStatistics::kNumberOfCuts; ++i)
+            {
+                tempState.passed.push_back(this->mStatistics.GetPassed(static_cast<RunStatistics::Cut>(i)));
+            }
+            if (!tempCheckpoint->Save(tempState, tempSelected) && this->mLogger->IsEnabled(Logger::kError))
+            {
+                this->mLogger->Write("cannot write checkpoint " + tempCheckpoint->GetFileName() + "\n");
+            }
+        }
+    }
+    // all event output is written before the run report
+    this->mLogger.reset();
+    this->mTruthSidecars.clear();
+
+    for (Worker& tempWorker : tempWorkers)
+    {
+        tempWorker.analysis.reset();
+        tempWorker.chain.reset();
+        delete tempWorker.event;
+        tempWorker.event = NULL;
+    }
+
+    tempDeltaTNeutron.AddTo(*this->mDeltaTNeutron);
+    tempDeltaTOther.AddTo(*this->mDeltaTOther);
+    if (this->mSummaryWriter)
+    {
+        // mergeable outputs of this shard, see merge.cpp
+        this->mSummaryWriter->WriteObject(*this->mDeltaTNeutron, "deltaTNeutron");
+        this->mSummaryWriter->WriteObject(*this->mDeltaTOther, "deltaTOther");
+#ifdef TEST_ANALYSIS_INSTRUMENTATION
+        TH1D tempCutFlow("", "cut flow", RunStatistics::kNumberOfCuts, 0, RunStatistics::kNumberOfCuts);
+        tempCutFlow.SetDirectory(NULL);
+        for (int i = 0; i < RunStatistics::kNumberOfCuts; ++i)
+        {
+            tempCutFlow.SetBinContent(i + 1, this->mStatistics.GetPassed(static_cast<RunStatistics::Cut>(i)));
+            tempCutFlow.GetXaxis()->SetBinLabel(i + 1, RunStatistics::GetCutName(static_cast<RunStatistics::Cut>(i)));
+        }
+        this->mSummaryWriter->WriteObject(tempCutFlow, "cutFlow");
+#endif
+        this->mSummaryWriter->WriteShardInfo(tempFirstEntry, tempLastEntry, this->mShard, this->mNumberOfShards);
+        this->mSummaryWriter->Close();
+        this->mSummaryWriter.reset();
+    }
+
+#ifdef TEST_ANALYSIS_INSTRUMENTATION
+    const double tempWallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tempStartTime).count();
+    const Long64_t tempFileBytes = TFile::GetFileBytesRead() - tempStartFileBytes;
+    this->mStatistics.Print(std::cout, tempWallTime, tempFileBytes);
+    if (!this->mStatisticsFileName.empty() && !this->mStatistics.WriteJson(this->mStatisticsFileName, tempWallTime, tempFileBytes))
+    {
+        std::cout << "cannot write run statistics to " << this->mStatisticsFileName << std::endl;
+    }
+#else
+    (void)tempStartTime;
+    (void)tempStartFileBytes;
+#endif
+
+    if (this->mSkim && !tempEntryList && !tempFullRange)
+    {
+        std::cout << "skim index is written only when all entries are analyzed" << std::endl;
+    }
+    else if (this->mSkim && !tempEntryList)
+    {
+        std::vector<Long64_t>::const_iterator tempSelectedEntry = tempSelected.begin();
+        for (const InputFile& tempInputFile : tempInputFiles)
+        {
+            std::vector<Long64_t> tempLocalEntries;
+            for (; tempSelectedEntry != tempSelected.end()
+                    && *tempSelectedEntry < tempInputFile.offset + tempInputFile.entries;
+                    ++tempSelectedEntry)
+            {
+                tempLocalEntries.push_back(*tempSelectedEntry - tempInputFile.offset);
+            }
+            SkimIndex tempSkimIndex(tempInputFile.name);
+            tempSkimIndex.SetEntries(std::move(tempLocalEntries));
+            if (tempSkimIndex.Save(tempInputFile.entries))
+            {
+                std::cout << "skim index written to " << tempSkimIndex.GetIndexFileName() << std::endl;
+            }
+            else
+            {
+                std::cout << "cannot write skim index " << tempSkimIndex.GetIndexFileName() << std::endl;
+            }
+        }
+    }
+    if (!this->mSlimFileName.empty() && !SkimIndex::WriteEvents(*tempCubeReconTree, tempSelected, this->mSlimFileName))
+    {
+        std::cout << "cannot write selected events to " << this->mSlimFileName << std::endl;
+    }
+
+    if (tempCheckpoint)
+    {
+        tempCheckpoint->Remove();
+    }
+    return true;
+}
+
+void EventLoop::CollectWorkers(std::vector<Worker>& inWorkers, HistogramBuffer& outDeltaTNeutron,
+        HistogramBuffer& outDeltaTOther, std::vector<Long64_t>& outSelected)
+{
+    for (Worker& tempWorker : inWorkers)
+    {
+        this->mLogger->Write(tempWorker.output);
+        outSelected.insert(outSelected.end(), tempWorker.selected.begin(), tempWorker.selected.end());
+        tempWorker.selected.clear();
+        outDeltaTNeutron.Merge(*tempWorker.deltaTNeutron);
+        outDeltaTOther.Merge(*tempWorker.deltaTOther);
+        tempWorker.deltaTNeutron->Reset();
+        tempWorker.deltaTOther->Reset();
+        if (tempWorker.summary)
+        {
+            tempWorker.summary->Flush();
+        }
+        this->mStatistics.Merge(tempWorker.statistics);
+        tempWorker.statistics = RunStatistics();
+    }
+}
+
+bool EventLoop::Resume(const CheckpointState& inState, HistogramBuffer& outDeltaTNeutron,
+        HistogramBuffer& outDeltaTOther)
+{
+    if (inState.deltaTNeutron.size() != outDeltaTNeutron.GetContents().size()
+            || inState.deltaTOther.size() != outDeltaTOther.GetContents().size()
+            || inState.passed.size() != static_cast<std::size_t>(RunStatistics::kNumberOfCuts))
+    {
+        return false;
+    }
+
+    if (!this->mSummaryFileName.empty() && inState.numberOfSummaryRows > 0)
+    {
+        // rows after the checkpoint are dropped: copy the rest to a new file
+        const std::string tempPreviousFileName = this->mSummaryFileName + ".resume";
+        if (std::rename(this->mSummaryFileName.c_str(), tempPreviousFileName.c_str()) != 0)
+        {
+            return false;
+        }
+        this->mSummaryWriter = std::make_unique<SummaryWriter> (this->mSummaryFileName);
+        if (!this->mSummaryWriter->IsOpen())
+        {
+            this->mSummaryWriter.reset();
+            std::rename(tempPreviousFileName.c_str(), this->mSummaryFileName.c_str());
+            return false;
+        }
+        const bool tempCopied = this->mSummaryWriter->CopyRows(tempPreviousFileName, inState.numberOfSummaryRows);
+        std::remove(tempPreviousFileName.c_str());
+        if (!tempCopied)
+        {
+            this->mSummaryWriter.reset();
+            return false;
+        }
+    }
+
+    outDeltaTNeutron.SetContents(inState.deltaTNeutron);
+    outDeltaTOther.SetContents(inState.deltaTOther);
+    for (int i = 0; i < RunStatistics::kNumberOfCuts; ++i)
+    {
+        this->mStatistics.AddPassed(static_cast<RunStatistics::Cut>(i), inState.passed[i]);
+    }
+    return true;
+}
+
+void EventLoop::Process(Worker& inWorker, const std::vector<Long64_t>* inEntryList)
+{
+    if (!inWorker.chain)
+    {
+        inWorker.chain = this->MakeChain(true);
+        inWorker.chain->SetBranchAddress("Event", &inWorker.event);
+        inWorker.analysis = std::make_unique<EventAnalysis> (inWorker.event);
+    }
+    TChain* tempCubeReconTree = inWorker.chain.get();
+    const bool tempStreaming = this->mNumberOfThreads == 1 || !this->mOrdered;
+    if (this->mCacheSize > 0 && inWorker.first < inWorker.last)
+    {
+        const Long64_t tempFirst = inEntryList ? (*inEntryList)[inWorker.first] : inWorker.first;
+        const Long64_t tempLast = inEntryList ? (*inEntryList)[inWorker.last - 1] : inWorker.last - 1;
+        tempCubeReconTree->SetCacheEntryRange(tempFirst, tempLast + 1);
+    }
+
+    for (Long64_t n = inWorker.first; n < inWorker.last; n++)
+    {
+        const Long64_t i = inEntryList ? (*inEntryList)[n] : n;
+        Int_t tempBytes = 0;
+        {
+            RUN_STATISTICS_TIMER(inWorker.statistics, RunStatistics::kGetEntry);
+            tempBytes = tempCubeReconTree->GetEntry(i);
+        }
+        RUN_STATISTICS_BYTES(inWorker.statistics, tempBytes);
+        RUN_STATISTICS_PASS(inWorker.statistics, RunStatistics::kRead);
+        const int* tempMainTrajectories = NULL;
+        int tempNumberOfMainTrajectories = -1;
+        this->FindMainTrajectories(*tempCubeReconTree, i, tempMainTrajectories, tempNumberOfMainTrajectories);
+        this->ProcessEvent(inWorker.event, i, inWorker.output, inWorker,
+                tempMainTrajectories, tempNumberOfMainTrajectories);
+        // in ordered mode output is kept until all workers of the block are done
+        if (tempStreaming && inWorker.output.tellp() >= kLoggerBufferSize)
+        {
+            this->mLogger->Write(inWorker.output);
+        }
+    }
+}
+
+void EventLoop::ProcessEvent(Cube::Event* inEvent, Long64_t inEntry, std::ostream& out, Worker& inWorker,
+        const int* inMainTrajectories, int inNumberOfMainTrajectories)
+{
+    EventAnalysis* tempEventAnalysis = inWorker.analysis.get();
+    tempEventAnalysis->Reset(inEvent);
+    {
+        RUN_STATISTICS_TIMER(inWorker.statistics, RunStatistics::kTruthCounters);
+        tempEventAnalysis->SetTruthCounters();
+    }
+
+    //CC0pi, true selection
+    if (tempEventAnalysis->GetNumberOfPrimaryPionTrajectory() != 0 || tempEventAnalysis->GetNumberOfPrimaryAntiMuonTrajectory() != 1)
+    {
+        return;
+    }
+    RUN_STATISTICS_PASS(inWorker.statistics, RunStatistics::kTrueCC0pi);
+
+    EventAnalysis::Status tempStatus;
+    {
+        RUN_STATISTICS_TIMER(inWorker.statistics, RunStatistics::kCollectObjects);
+        Cube::Handle<Cube::AlgorithmResult> topResult(inEvent,false);
+        tempStatus = tempEventAnalysis->CollectObjects(topResult, inMainTrajectories, inNumberOfMainTrajectories);
+    }
+    if (tempStatus != EventAnalysis::kSuccess)
+    {
+        if (this->mLogger->IsEnabled(Logger::kEvent))
+        {
+            out << "exceptrion in event: " << inEntry << ", " << EventAnalysis::GetStatusMessage(tempStatus) << '\n';
+            out << "--------------------------------" << '\n';
+        }
+        return;
+    }
+    RUN_STATISTICS_PASS(inWorker.statistics, RunStatistics::kObjectContainer);
+
+    {
+        RUN_STATISTICS_TIMER(inWorker.statistics, RunStatistics::kAntiMuonObjects);
+        tempEventAnalysis->SetNumberOfPrimaryAntiMuonObject();
+    }
+    //seletion of single muon track event
+    if (tempEventAnalysis->GetNumberOfPrimaryAntiMuonObject() != 1)
+    {
+        return;
+    }
+    RUN_STATISTICS_PASS(inWorker.statistics, RunStatistics::kSingleAntiMuonObject);
+    inWorker.selected.push_back(inEntry);
+    if (this->mLogger->IsEnabled(Logger::kEvent))
+    {
+        out << "event: " << inEntry << '\n';
+    }
+    {
+        RUN_STATISTICS_TIMER(inWorker.statistics, RunStatistics::kVertex);
+        tempStatus = tempEventAnalysis->SetVertex();
+    }
+    if (tempStatus == EventAnalysis::kSuccess)
+    {
+        RUN_STATISTICS_PASS(inWorker.statistics, RunStatistics::kVertexCandidate);
+        RUN_STATISTICS_TIMER(inWorker.statistics, RunStatistics::kFirstObject);
+        tempStatus = tempEventAnalysis->SetFirstObject();
+    }
+    if (tempStatus != EventAnalysis::kSuccess)
+    {
+        if (this->mLogger->IsEnabled(Logger::kEvent))
+        {
+            out << EventAnalysis::GetStatusMessage(tempStatus) << '\n';
+            out << "--------------------------------" << '\n';
+        }
+        return;
+    }
+    RUN_STATISTICS_PASS(inWorker.statistics, RunStatistics::kFirstObjectCandidate);
+
+    {
+        RUN_STATISTICS_TIMER(inWorker.statistics, RunStatistics::kDeltaT);
+        HistogramBuffer& tempDeltaT = tempEventAnalysis->IsFirstObjectFromNeutron()
+            ? *inWorker.deltaTNeutron : *inWorker.deltaTOther;
+        tempDeltaT.Fill(tempEventAnalysis->GetFirstObjectDeltaT());
+    }
+
+    RUN_STATISTICS_TIMER(inWorker.statistics, RunStatistics::kOutput);
+    if (inWorker.summary)
+    {
+        inWorker.summary->Fill(SummaryWriter::MakeSummary(*tempEventAnalysis, inEntry));
+    }
+
+    if (!this->mLogger->IsEnabled(Logger::kEvent))
+    {
+        return;
+    }
+    if (this->mLogger->IsEnabled(Logger::kObjects))
+    {
+        tempEventAnalysis->ShowAllObjects(out);
+    }
+    tempEventAnalysis->ShowFirstObject(out);
+    tempEventAnalysis->ShowVertex(out);
+    out << "--------------------------------" << '\n';
+}
@@ -0,0 +1,448 @@
+#ifndef EVENTLOOP_HXX
+#define EVENTLOOP_HXX
+
+#include "EventAnalysis.hxx"
+#include "SummaryWriter.hxx"
+#include "RunStatistics.hxx"
+#include "HistogramBuffer.hxx"
+#include "Checkpoint.hxx"
+#include "Logger.hxx"
+#include "TruthSidecar.hxx"
+#include "EventStore.hxx"
+
+#include <TChain.h>
+#include <TH1.h>
+#include <Rtypes.h>
+
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief EventLoop class
+ * @details EventLoop reads CubeEvents tree and runs EventAnalysis
+ * on every entry. \n
+ * Entries are split into contiguous ranges, one per worker thread.
+ * Each worker has its own TChain, its own Cube::Event and its own
+ * delta T histogram buffers, which are merged at the end of Run(). \n
+ * In ordered mode, output of each worker is buffered and written in
+ * entry order, so output is the same as the serial run. Entries are
+ * then processed in blocks of at most 10000 entries, which bounds the
+ * buffered output and summary rows. \n
+ * Summary of selected events can be written to a ROOT ntuple
+ * instead of (or in addition to) the text output. \n
+ * Each worker reads through its own TTreeCache, with asynchronous
+ * prefetching and optional pruning of branches. \n
+ * A run can be limited to an entry range and to one shard of it, and
+ * can save a Checkpoint after every block of entries, so a failed job
+ * resumes where it stopped. \n
+ * Text output of events is formatted into per worker buffers and
+ * written by the background thread of a Logger, only up to the
+ * verbosity level of the run. \n
+ * Main trajectories of objects can be read from a TruthSidecar of each
+ * input file instead of Cube::Tool::MainTrajectory.
+ * @date 2026-10-17
+ */
+class EventLoop
+{
+    public:
+        /**
+         * @brief initializer
+         * @param const std::vector<std::string>& inFileNames: input file
+         * names, wildcards in the file name are expanded by TChain
+         * @param int inNumberOfThreads: number of worker threads,
+         * 0 means number of hardware threads
+         * @param bool inOrdered: write output in entry order
+         */
+        EventLoop(const std::vector<std::string>& inFileNames, int inNumberOfThreads = 1, bool inOrdered = true);
+
+        /**
+         * @brief set TTreeCache of each worker
+         * @param Long64_t inCacheSize: cache size in bytes, 0 disables the cache
+         * @param Int_t inLearnEntries: number of entries of the learning phase
+         */
+        void SetReadCache(Long64_t inCacheSize, Int_t inLearnEntries);
+
+        /**
+         * @brief enable asynchronous prefetching of baskets
+         */
+        void SetPrefetch(bool inPrefetch);
+
+        /**
+         * @brief read only branches matching inBranches
+         * @param const std::vector<std::string>& inBranches: branch name
+         * patterns (e.g. "Event.G4Trajectories*"), empty means all branches
+         */
+        void SetBranches(const std::vector<std::string>& inBranches);
+
+        /**
+         * @brief write summary of selected events to ntuple file
+         * @param const std::string& inFileName: output ROOT file name,
+         * empty string disables the ntuple output
+         */
+        void SetSummaryFile(const std::string& inFileName);
+
+        /**
+         * @brief do not write per event text output
+         * @details same as SetVerbosity(Logger::kError).
+         */
+        void SetQuiet(bool inQuiet);
+
+        /**
+         * @brief set verbosity of text output
+         * @param int inVerbosity: Logger::Level, messages up to this level
+         * are written, default Logger::kObjects
+         */
+        void SetVerbosity(int inVerbosity);
+
+        /**
+         * @brief use skim index of selected entries
+         * @details if a valid SkimIndex of every input file exists only
+         * their entries are read, otherwise all entries are read and the
+         * indices are written for later runs.
+         */
+        void SetSkim(bool inSkim);
+
+        /**
+         * @brief write selected events to slimmed output file
+         * @param const std::string& inFileName: output ROOT file name,
+         * empty string disables the slimmed output
+         */
+        void SetSlimFile(const std::string& inFileName);
+
+        /**
+         * @brief write run statistics to JSON file
+         * @details only if built with TEST_ANALYSIS_INSTRUMENTATION.
+         * @param const std::string& inFileName: output file name,
+         * empty string disables the JSON report
+         */
+        void SetStatisticsFile(const std::string& inFileName);
+
+        /**
+         * @brief analyze only entries [inFirst, inLast)
+         * @param Long64_t inFirst: first entry
+         * @param Long64_t inLast: last entry, not included, -1 means
+         * number of entries
+         */
+        void SetEntryRange(Long64_t inFirst, Long64_t inLast);
+
+        /**
+         * @brief analyze only one shard of the entry range
+         * @details the entry range is split into inNumberOfShards
+         * contiguous parts. Outputs of all shards can be merged with
+         * test_analysis_merge.
+         * @param int inShard: shard index, 0 <= inShard < inNumberOfShards
+         * @param int inNumberOfShards: number of shards
+         */
+        void SetShard(int inShard, int inNumberOfShards);
+
+        /**
+         * @brief save checkpoint every inInterval entries
+         * @details if inFileName has a checkpoint of the same inputs and
+         * range, the run resumes from it. The checkpoint is removed when
+         * the run is complete.
+         * @param const std::string& inFileName: checkpoint file name,
+         * empty string disables checkpoints
+         * @param Long64_t inInterval: number of entries per block
+         */
+        void SetCheckpoint(const std::string& inFileName, Long64_t inInterval);
+
+        /**
+         * @brief read main trajectories from TruthSidecar of input files
+         * @details input files without a valid sidecar, and entries whose
+         * number of objects does not match, are truth matched as before.
+         */
+        void SetTruthSidecar(bool inTruthSidecar);
+
+        /**
+         * @brief write TruthSidecar of every input file
+         * @details all entries are read and truth matched, input files
+         * are processed in parallel by the worker threads.
+         * @return bool false if a sidecar cannot be written
+         */
+        bool MakeTruthSidecars();
+
+        /**
+         * @brief read all entries of the range into an event store
+         * @details every entry is kept, whether it passes the selection
+         * or not, so EventStore::Select() can apply other cuts. Entries
+         * are read in parallel by the worker threads. TruthSidecar is
+         * used if enabled.
+         * @param EventStore& outStore: store, previous events are removed
+         * @return bool false if there is no input
+         */
+        bool FillEventStore(EventStore& outStore);
+
+        /**
+         * @brief get merged cut flow and timing of the last run
+         * @return const RunStatistics&, empty unless built with
+         * TEST_ANALYSIS_INSTRUMENTATION
+         */
+        const RunStatistics& GetStatistics() const;
+
+        /**
+         * @brief run analysis on all entries
+         * @return bool false if the input tree or the summary file cannot be opened
+         */
+        bool Run();
+
+        /**
+         * @brief get merged delta T histogram of neutron first object
+         * @details delta T is first object time - vertex time of
+         * selected events.
+         */
+        TH1F* GetDeltaTNeutron() const;
+
+        /**
+         * @brief get merged delta T histogram of other first object
+         */
+        TH1F* GetDeltaTOther() const;
+
+    private:
+        /**
+         * @brief file of the input chain
+         */
+        struct InputFile
+        {
+            std::string name;
+            Long64_t offset = 0;
+            Long64_t entries = 0;
+        };
+
+        /**
+         * @brief apply read settings which are global to ROOT
+         * @details asynchronous prefetching. Called once by every entry
+         * point which reads events, before any chain is made.
+         */
+        void SetUpReading() const;
+
+        /**
+         * @brief make chain of input files
+         * @param bool inReader: configure branches and read cache for
+         * reading events
+         */
+        std::unique_ptr<TChain> MakeChain(bool inReader) const;
+
+        /**
+         * @brief list files of chain with their entry offset
+         * @details GetEntries() of inChain should be already called.
+         */
+        static std::vector<InputFile> ListInputFiles(TChain& inChain);
+
+        /**
+         * @brief state of one worker thread
+         * @details chain and event are kept for all blocks of the run.
+         */
+        struct Worker
+        {
+            Long64_t first = 0;
+            Long64_t last = 0;
+            std::unique_ptr<TChain> chain;
+            Cube::Event* event = NULL;
+            std::ostringstream output;
+            std::unique_ptr<HistogramBuffer> deltaTNeutron;
+            std::unique_ptr<HistogramBuffer> deltaTOther;
+            std::unique_ptr<SummaryBuffer> summary;
+            std::vector<Long64_t> selected;
+            RunStatistics statistics;
+            std::unique_ptr<EventAnalysis> analysis;
+        };
+
+        /**
+         * @brief collect results of workers after a block
+         * @details output is written in worker order, results are moved
+         * to the outputs, and workers are ready for the next block.
+         */
+        void CollectWorkers(std::vector<Worker>& inWorkers, HistogramBuffer& outDeltaTNeutron,
+                HistogramBuffer& outDeltaTOther, std::vector<Long64_t>& outSelected);
+
+        /**
+         * @brief restore results of checkpoint
+         * @details summary rows are copied from the previous output file,
+         * so this is called before the summary writer is made. Selected
+         * entries are loaded by Checkpoint::Load().
+         * @return bool false if checkpoint cannot be used, nothing is restored then
+         */
+        bool Resume(const CheckpointState& inState, HistogramBuffer& outDeltaTNeutron,
+                HistogramBuffer& outDeltaTOther);
+
+        /**
+         * @brief get entries [outFirst, outLast) of entry range and shard
+         */
+        void GetEntryRange(Long64_t inNumberOfEntries, Long64_t& outFirst, Long64_t& outLast) const;
+
+        /**
+         * @brief open TruthSidecar of input files if enabled
+         */
+        void OpenTruthSidecars(const std::vector<InputFile>& inInputFiles);
+
+        /**
+         * @brief find main trajectories of entry in TruthSidecar
+         * @details outputs are not changed if there is no sidecar of the
+         * current file of inChain. GetEntry(inEntry) should be already called.
+         */
+        void FindMainTrajectories(const TChain& inChain, Long64_t inEntry,
+                const int*& outMainTrajectories, int& outNumberOfMainTrajectories) const;
+
+        /**
+         * @brief read entries [inFirst, inLast) into event store
+         */
+        void FillEventStoreRange(Long64_t inFirst, Long64_t inLast, EventStore& outStore);
+
+        /**
+         * @brief write TruthSidecar of one input file
+         */
+        bool MakeTruthSidecar(const InputFile& inInputFile) const;
+
+        /**
+         * @brief read and analyze entries [first, last) of worker
+         * @param Worker& inWorker: worker to run
+         * @param const std::vector<Long64_t>* inEntryList: if not NULL,
+         * [first, last) are positions in this list instead of entries
+         */
+        void Process(Worker& inWorker, const std::vector<Long64_t>* inEntryList);
+
+        /**
+         * @brief analyze one entry
+         * @details analysis of the worker is reset and reused.
+         * @param Cube::Event* inEvent: event read from the tree
+         * @param Long64_t inEntry: entry number of event
+         * @param std::ostream& out: output buffer of the worker
+         * @param Worker& inWorker: worker analyzing this event
+         * @param const int* inMainTrajectories: main trajectories of
+         * TruthSidecar, NULL if not available
+         * @param int inNumberOfMainTrajectories: size of inMainTrajectories
+         */
+        void ProcessEvent(Cube::Event* inEvent, Long64_t inEntry, std::ostream& out, Worker& inWorker,
+                const int* inMainTrajectories, int inNumberOfMainTrajectories);
+
+        /**
+         * @brief input file names
+         */
+        std::vector<std::string> mFileNames;
+
+        /**
+         * @brief TTreeCache size in bytes of each worker
+         */
+        Long64_t mCacheSize = 32 * 1024 * 1024;
+
+        /**
+         * @brief number of entries of the TTreeCache learning phase
+         */
+        Int_t mLearnEntries = 10;
+
+        /**
+         * @brief asynchronous prefetching of baskets
+         */
+        bool mPrefetch = true;
+
+        /**
+         * @brief branch name patterns to read, empty means all
+         */
+        std::vector<std::string> mBranches;
+
+        /**
+         * @brief number of worker threads
+         */
+        int mNumberOfThreads = 1;
+
+        /**
+         * @brief write output in entry order
+         */
+        bool mOrdered = true;
+
+        /**
+         * @brief summary ntuple file name
+         */
+        std::string mSummaryFileName;
+
+        /**
+         * @brief verbosity of text output, Logger::Level
+         */
+        int mVerbosity = Logger::kObjects;
+
+        /**
+         * @brief use skim index of selected entries
+         */
+        bool mSkim = false;
+
+        /**
+         * @brief slimmed output file name
+         */
+        std::string mSlimFileName;
+
+        /**
+         * @brief first entry to analyze
+         */
+        Long64_t mFirstEntry = 0;
+
+        /**
+         * @brief last entry to analyze, not included, -1 means all
+         */
+        Long64_t mLastEntry = -1;
+
+        /**
+         * @brief shard index of this run
+         */
+        int mShard = 0;
+
+        /**
+         * @brief number of shards of the entry range
+         */
+        int mNumberOfShards = 1;
+
+        /**
+         * @brief checkpoint file name, empty means no checkpoint
+         */
+        std::string mCheckpointFileName;
+
+        /**
+         * @brief number of entries between checkpoints
+         */
+        Long64_t mCheckpointInterval = 100000;
+
+        /**
+         * @brief read main trajectories from TruthSidecar
+         */
+        bool mTruthSidecar = false;
+
+        /**
+         * @brief TruthSidecar of each input file during the run, NULL if
+         * missing or stale
+         */
+        std::vector<std::unique_ptr<TruthSidecar>> mTruthSidecars;
+
+        /**
+         * @brief run statistics JSON file name
+         */
+        std::string mStatisticsFileName;
+
+        /**
+         * @brief merged cut flow and timing
+         */
+        RunStatistics mStatistics;
+
+        /**
+         * @brief summary ntuple writer, NULL if disabled
+         */
+        std::unique_ptr<SummaryWriter> mSummaryWriter;
+
+        /**
+         * @brief writer of event text output, only during the event loop
+         */
+        std::unique_ptr<Logger> mLogger;
+
+        /**
+         * @brief merged delta T histogram, neutron
+         */
+        std::unique_ptr<TH1F> mDeltaTNeutron;
+
+        /**
+         * @brief merged delta T histogram, other
+         */
+        std::unique_ptr<TH1F> mDeltaTOther;
+};
+
+#endif
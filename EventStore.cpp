@@ -0,0 +1,262 @@
+#include "EventStore.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <thread>
+
+namespace
+{
+    /**
+     * @brief counter of a few bits, larger values are kept as 255
+     */
+    unsigned char MakeCount(int inCount)
+    {
+        return static_cast<unsigned char>(std::min(std::max(inCount, 0), 255));
+    }
+
+    template <class T>
+    std::size_t GetColumnSize(const std::vector<T>& inColumn)
+    {
+        return inColumn.capacity() * sizeof(T);
+    }
+
+    template <class T>
+    void AppendColumn(std::vector<T>& outColumn, const std::vector<T>& inColumn)
+    {
+        outColumn.insert(outColumn.end(), inColumn.begin(), inColumn.end());
+    }
+}
+
+void EventStore::Clear()
+{
+    *this = EventStore();
+}
+
+void EventStore::Add(const EventAnalysis& inEventAnalysis, Long64_t inEntry, bool inHasObjects, bool inHasVertex)
+{
+    this->mEntry.push_back(inEntry);
+    this->mNumberOfPrimaryPions.push_back(MakeCount(inEventAnalysis.GetNumberOfPrimaryPionTrajectory()));
+    this->mNumberOfPrimaryAntiMuons.push_back(MakeCount(inEventAnalysis.GetNumberOfPrimaryAntiMuonTrajectory()));
+    this->mNumberOfPrimaryAntiMuonObjects.push_back(MakeCount(inHasObjects ? inEventAnalysis.GetNumberOfPrimaryAntiMuonObject() : 0));
+    this->mHasObjects.push_back(inHasObjects);
+    this->mHasVertex.push_back(inHasObjects && inHasVertex);
+    const TLorentzVector& tempVertex = inEventAnalysis.GetVertex();
+    this->mVertexX.push_back(tempVertex.X());
+    this->mVertexY.push_back(tempVertex.Y());
+    this->mVertexZ.push_back(tempVertex.Z());
+    this->mVertexT.push_back(tempVertex.T());
+
+    if (inHasObjects)
+    {
+        const ObjectSnapshot& tempSnapshot = inEventAnalysis.GetSnapshot();
+        this->mX.insert(this->mX.end(), tempSnapshot.GetX().begin(), tempSnapshot.GetX().end());
+        this->mY.insert(this->mY.end(), tempSnapshot.GetY().begin(), tempSnapshot.GetY().end());
+        this->mZ.insert(this->mZ.end(), tempSnapshot.GetZ().begin(), tempSnapshot.GetZ().end());
+        AppendColumn(this->mT, tempSnapshot.GetT());
+        this->mKind.insert(this->mKind.end(), tempSnapshot.GetKind().begin(), tempSnapshot.GetKind().end());
+        AppendColumn(this->mPdg, tempSnapshot.GetPdg());
+        AppendColumn(this->mParentId, tempSnapshot.GetParentId());
+        AppendColumn(this->mAncestorFlags, tempSnapshot.GetAncestorFlags());
+    }
+    this->mObjectOffset.push_back(this->mT.size());
+}
+
+void EventStore::Append(const EventStore& inStore)
+{
+    const std::size_t tempObjectOffset = this->mT.size();
+    AppendColumn(this->mEntry, inStore.mEntry);
+    AppendColumn(this->mNumberOfPrimaryPions, inStore.mNumberOfPrimaryPions);
+    AppendColumn(this->mNumberOfPrimaryAntiMuons, inStore.mNumberOfPrimaryAntiMuons);
+    AppendColumn(this->mNumberOfPrimaryAntiMuonObjects, inStore.mNumberOfPrimaryAntiMuonObjects);
+    AppendColumn(this->mHasObjects, inStore.mHasObjects);
+    AppendColumn(this->mHasVertex, inStore.mHasVertex);
+    AppendColumn(this->mVertexX, inStore.mVertexX);
+    AppendColumn(this->mVertexY, inStore.mVertexY);
+    AppendColumn(this->mVertexZ, inStore.mVertexZ);
+    AppendColumn(this->mVertexT, inStore.mVertexT);
+    for (std::size_t i = 1; i < inStore.mObjectOffset.size(); ++i)
+    {
+        this->mObjectOffset.push_back(tempObjectOffset + inStore.mObjectOffset[i]);
+    }
+    AppendColumn(this->mX, inStore.mX);
+    AppendColumn(this->mY, inStore.mY);
+    AppendColumn(this->mZ, inStore.mZ);
+    AppendColumn(this->mT, inStore.mT);
+    AppendColumn(this->mKind, inStore.mKind);
+    AppendColumn(this->mPdg, inStore.mPdg);
+    AppendColumn(this->mParentId, inStore.mParentId);
+    AppendColumn(this->mAncestorFlags, inStore.mAncestorFlags);
+}
+
+std::size_t EventStore::GetNumberOfEvents() const
+{
+    return this->mEntry.size();
+}
+
+std::size_t EventStore::GetNumberOfObjects() const
+{
+    return this->mT.size();
+}
+
+std::size_t EventStore::GetMemorySize() const
+{
+    return GetColumnSize(this->mEntry)
+        + GetColumnSize(this->mNumberOfPrimaryPions)
+        + GetColumnSize(this->mNumberOfPrimaryAntiMuons)
+        + GetColumnSize(this->mNumberOfPrimaryAntiMuonObjects)
+        + GetColumnSize(this->mHasObjects)
+        + GetColumnSize(this->mHasVertex)
+        + GetColumnSize(this->mVertexX)
+        + GetColumnSize(this->mVertexY)
+        + GetColumnSize(this->mVertexZ)
+        + GetColumnSize(this->mVertexT)
+        + GetColumnSize(this->mObjectOffset)
+        + GetColumnSize(this->mX)
+        + GetColumnSize(this->mY)
+        + GetColumnSize(this->mZ)
+        + GetColumnSize(this->mT)
+        + GetColumnSize(this->mKind)
+        + GetColumnSize(this->mPdg)
+        + GetColumnSize(this->mParentId)
+        + GetColumnSize(this->mAncestorFlags);
+}
+
+std::size_t EventStore::GetObjectOffset(std::size_t inEvent) const
+{
+    return this->mObjectOffset[inEvent];
+}
+
+Long64_t EventStore::GetEntry(std::size_t inEvent) const
+{
+    return this->mEntry[inEvent];
+}
+
+EventStore::Result EventStore::Select(const Selection& inSelection, int inNumberOfThreads, Variable inVariable,
+        HistogramBuffer* outNeutron, HistogramBuffer* outOther) const
+{
+    const std::size_t tempNumberOfEvents = this->GetNumberOfEvents();
+    const int tempNumberOfWorkers = static_cast<int>(std::max<std::size_t>(1,
+                std::min<std::size_t>(std::max(1, inNumberOfThreads), tempNumberOfEvents)));
+
+    // same as EventLoop: contiguous ranges, per worker results merged at the end
+    std::vector<Result> tempResults(tempNumberOfWorkers);
+    std::vector<std::unique_ptr<HistogramBuffer>> tempNeutron(tempNumberOfWorkers);
+    std::vector<std::unique_ptr<HistogramBuffer>> tempOther(tempNumberOfWorkers);
+    std::vector<std::thread> tempThreads;
+    for (int w = 0; w < tempNumberOfWorkers; ++w)
+    {
+        if (outNeutron)
+        {
+            tempNeutron[w] = std::make_unique<HistogramBuffer> (*outNeutron);
+            tempNeutron[w]->Reset();
+        }
+        if (outOther)
+        {
+            tempOther[w] = std::make_unique<HistogramBuffer> (*outOther);
+            tempOther[w]->Reset();
+        }
+        const std::size_t tempFirst = tempNumberOfEvents * w / tempNumberOfWorkers;
+        const std::size_t tempLast = tempNumberOfEvents * (w + 1) / tempNumberOfWorkers;
+        tempThreads.emplace_back([this, &inSelection, tempFirst, tempLast, inVariable, w,
+                &tempResults, &tempNeutron, &tempOther]()
+                {
+                    this->Select(inSelection, tempFirst, tempLast, inVariable,
+                            tempResults[w], tempNeutron[w].get(), tempOther[w].get());
+                });
+    }
+    for (std::thread& tempThread : tempThreads)
+    {
+        tempThread.join();
+    }
+
+    Result tempResult;
+    for (int w = 0; w < tempNumberOfWorkers; ++w)
+    {
+        for (int i = 0; i < RunStatistics::kNumberOfCuts; ++i)
+        {
+            tempResult.passed[i] += tempResults[w].passed[i];
+        }
+        tempResult.neutron += tempResults[w].neutron;
+        if (outNeutron)
+        {
+            outNeutron->Merge(*tempNeutron[w]);
+        }
+        if (outOther)
+        {
+            outOther->Merge(*tempOther[w]);
+        }
+    }
+    return tempResult;
+}
+
+void EventStore::Select(const Selection& inSelection, std::size_t inFirst, std::size_t inLast, Variable inVariable,
+        Result& outResult, HistogramBuffer* outNeutron, HistogramBuffer* outOther) const
+{
+    // one mask per thread, reused by all events of the range
+    std::vector<unsigned char> tempMask;
+    for (std::size_t i = inFirst; i < inLast; ++i)
+    {
+        outResult.passed[RunStatistics::kRead]++;
+        if (this->mNumberOfPrimaryPions[i] > inSelection.maxPrimaryPions
+                || this->mNumberOfPrimaryAntiMuons[i] != inSelection.primaryAntiMuons)
+        {
+            continue;
+        }
+        outResult.passed[RunStatistics::kTrueCC0pi]++;
+        if (!this->mHasObjects[i])
+        {
+            continue;
+        }
+        outResult.passed[RunStatistics::kObjectContainer]++;
+        if (this->mNumberOfPrimaryAntiMuonObjects[i] != inSelection.primaryAntiMuonObjects)
+        {
+            continue;
+        }
+        outResult.passed[RunStatistics::kSingleAntiMuonObject]++;
+        if (!this->mHasVertex[i])
+        {
+            continue;
+        }
+        outResult.passed[RunStatistics::kVertexCandidate]++;
+        const std::size_t tempFirstObject = this->FindFirstObject(inSelection, i, tempMask);
+        if (tempFirstObject >= this->GetNumberOfObjects())
+        {
+            continue;
+        }
+        outResult.passed[RunStatistics::kFirstObjectCandidate]++;
+
+        const bool tempNeutron = this->mPdg[tempFirstObject] == 2112
+            || (this->mAncestorFlags[tempFirstObject] & TruthIndex::kNeutronAncestor) != 0;
+        outResult.neutron += tempNeutron;
+        HistogramBuffer* tempHistogram = tempNeutron ? outNeutron : outOther;
+        if (!tempHistogram)
+        {
+            continue;
+        }
+        if (inVariable == kDeltaT)
+        {
+            tempHistogram->Fill(this->mT[tempFirstObject] - this->mVertexT[i]);
+        }
+        else
+        {
+            const double tempDx = this->mX[tempFirstObject] - this->mVertexX[i];
+            const double tempDy = this->mY[tempFirstObject] - this->mVertexY[i];
+            const double tempDz = this->mZ[tempFirstObject] - this->mVertexZ[i];
+            tempHistogram->Fill(std::sqrt(tempDx * tempDx + tempDy * tempDy + tempDz * tempDz));
+        }
+    }
+}
+
+std::size_t EventStore::FindFirstObject(const Selection& inSelection, std::size_t inEvent,
+        std::vector<unsigned char>& outMask) const
+{
+    // same kernels as EventAnalysis::SetFirstObject, on the rows of this event
+    const std::size_t tempOffset = this->mObjectOffset[inEvent];
+    const std::size_t tempSize = this->mObjectOffset[inEvent + 1] - tempOffset;
+    outMask.resize(tempSize);
+    ObjectSnapshot::SelectFirstObjectCandidates(this->mPdg.data() + tempOffset, this->mAncestorFlags.data() + tempOffset,
+            tempSize, inSelection.rejectedPdgs, inSelection.rejectedAncestors, outMask.data());
+    const int tempIndex = ObjectSnapshot::FindEarliest(this->mT.data() + tempOffset, outMask.data(), tempSize);
+    return tempIndex < 0 ? this->GetNumberOfObjects() : tempOffset + tempIndex;
+}
@@ -0,0 +1,198 @@
+#ifndef EVENTSTORE_HXX
+#define EVENTSTORE_HXX
+
+#include "EventAnalysis.hxx"
+#include "HistogramBuffer.hxx"
+#include "RunStatistics.hxx"
+#include "TruthIndex.hxx"
+
+#include <Rtypes.h>
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief EventStore class
+ * @details EventStore keeps a compact summary of every analyzed entry
+ * in memory: truth counters, number of primary anti muon objects,
+ * vertex candidate and time, position, pdg, parent and ancestry of
+ * every object. \n
+ * Columns are contiguous, objects of event i are rows
+ * [GetObjectOffset(i), GetObjectOffset(i + 1)) of the object columns. \n
+ * Select() applies a Selection to all events in parallel, so cuts can
+ * be changed without reading the CubeEvents tree again. Positions are
+ * kept in float, times in double so delta T is the same as in EventLoop.
+ * @date 2026-10-17
+ */
+class EventStore
+{
+    public:
+        /**
+         * @brief cuts of the event selection
+         * @details default values are the selection of EventLoop.
+         */
+        struct Selection
+        {
+            /**
+             * @brief maximum number of primary pions (true)
+             */
+            int maxPrimaryPions = 0;
+
+            /**
+             * @brief required number of primary anti muons (true)
+             */
+            int primaryAntiMuons = 1;
+
+            /**
+             * @brief required number of primary anti muon objects
+             */
+            int primaryAntiMuonObjects = 1;
+
+            /**
+             * @brief pdg codes which cannot be first object
+             */
+            std::vector<int> rejectedPdgs = {-13, 0};
+
+            /**
+             * @brief TruthIndex::AncestorFlag of objects which cannot be first object
+             */
+            unsigned int rejectedAncestors = TruthIndex::kMuonAncestor;
+        };
+
+        /**
+         * @brief variable of histogram of selected events
+         */
+        enum Variable
+        {
+            kDeltaT = 0, //first object time - vertex time
+            kDistance //distance of first object to vertex
+        };
+
+        /**
+         * @brief result of Select()
+         */
+        struct Result
+        {
+            /**
+             * @brief number of events passing each cut
+             */
+            Long64_t passed[RunStatistics::kNumberOfCuts] = {};
+
+            /**
+             * @brief selected events with first object from neutron
+             */
+            Long64_t neutron = 0;
+        };
+
+        /**
+         * @brief remove all events
+         */
+        void Clear();
+
+        /**
+         * @brief add analyzed entry
+         * @details truth counters should be set. If inHasObjects,
+         * objects should be collected and number of primary anti muon
+         * objects set, inHasVertex tells if SetVertex() succeeded.
+         * @param const EventAnalysis& inEventAnalysis: analysis of the entry
+         * @param Long64_t inEntry: entry number
+         * @param bool inHasObjects: CollectObjects() succeeded
+         * @param bool inHasVertex: vertex candidate was found
+         */
+        void Add(const EventAnalysis& inEventAnalysis, Long64_t inEntry, bool inHasObjects, bool inHasVertex);
+
+        /**
+         * @brief append events of other store
+         */
+        void Append(const EventStore& inStore);
+
+        /**
+         * @brief get number of events
+         */
+        std::size_t GetNumberOfEvents() const;
+
+        /**
+         * @brief get number of objects of all events
+         */
+        std::size_t GetNumberOfObjects() const;
+
+        /**
+         * @brief get memory used by the columns in bytes
+         */
+        std::size_t GetMemorySize() const;
+
+        /**
+         * @brief get row of first object of event
+         * @param std::size_t inEvent: event index, GetNumberOfEvents() gives
+         * the number of objects
+         */
+        std::size_t GetObjectOffset(std::size_t inEvent) const;
+
+        /**
+         * @brief get entry number of event
+         */
+        Long64_t GetEntry(std::size_t inEvent) const;
+
+        /**
+         * @brief apply selection to all events
+         * @param const Selection& inSelection: cuts
+         * @param int inNumberOfThreads: number of threads
+         * @param Variable inVariable: variable of histograms
+         * @param HistogramBuffer* outNeutron: filled with selected events of
+         * neutron first object, may be NULL
+         * @param HistogramBuffer* outOther: filled with other selected events,
+         * may be NULL
+         * @return Result cut flow of the selection
+         */
+        Result Select(const Selection& inSelection, int inNumberOfThreads, Variable inVariable = kDeltaT,
+                HistogramBuffer* outNeutron = NULL, HistogramBuffer* outOther = NULL) const;
+
+    private:
+        /**
+         * @brief apply selection to events [inFirst, inLast)
+         */
+        void Select(const Selection& inSelection, std::size_t inFirst, std::size_t inLast, Variable inVariable,
+                Result& outResult, HistogramBuffer* outNeutron, HistogramBuffer* outOther) const;
+
+        /**
+         * @brief find first object of event
+         * @param std::vector<unsigned char>& outMask: selection of the rows
+         * of the event, reused between events
+         * @return std::size_t object row, GetNumberOfObjects() if not found
+         */
+        std::size_t FindFirstObject(const Selection& inSelection, std::size_t inEvent,
+                std::vector<unsigned char>& outMask) const;
+
+        /**
+         * @brief event columns, one entry per event
+         */
+        std::vector<Long64_t> mEntry;
+        std::vector<unsigned char> mNumberOfPrimaryPions;
+        std::vector<unsigned char> mNumberOfPrimaryAntiMuons;
+        std::vector<unsigned char> mNumberOfPrimaryAntiMuonObjects;
+        std::vector<unsigned char> mHasObjects;
+        std::vector<unsigned char> mHasVertex;
+        std::vector<float> mVertexX;
+        std::vector<float> mVertexY;
+        std::vector<float> mVertexZ;
+        std::vector<double> mVertexT;
+
+        /**
+         * @brief first object row of each event, one more than events
+         */
+        std::vector<std::size_t> mObjectOffset = {0};
+
+        /**
+         * @brief object columns, one entry per object
+         */
+        std::vector<float> mX;
+        std::vector<float> mY;
+        std::vector<float> mZ;
+        std::vector<double> mT;
+        std::vector<unsigned char> mKind;
+        std::vector<int> mPdg;
+        std::vector<int> mParentId;
+        std::vector<unsigned int> mAncestorFlags;
+};
+
+#endif
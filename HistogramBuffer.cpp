@@ -0,0 +1,86 @@
+#include "HistogramBuffer.hxx"
+
+#include <TAxis.h>
+
+#include <algorithm>
+
+HistogramBuffer::HistogramBuffer(int inNumberOfBins, double inLow, double inHigh)
+    : mNumberOfBins(inNumberOfBins)
+      ,mLow(inLow)
+      ,mHigh(inHigh)
+      ,mContents(inNumberOfBins + 2, 0.0)
+{
+}
+
+HistogramBuffer::HistogramBuffer(const TH1& inHistogram)
+    : HistogramBuffer(inHistogram.GetNbinsX(),
+            inHistogram.GetXaxis()->GetXmin(),
+            inHistogram.GetXaxis()->GetXmax())
+{
+}
+
+void HistogramBuffer::Fill(double inValue, double inWeight)
+{
+    int tempBin;
+    if (inValue < this->mLow)
+    {
+        tempBin = 0;
+    }
+    else if (!(inValue < this->mHigh))
+    {
+        // overflow, NaN included
+        tempBin = this->mNumberOfBins + 1;
+    }
+    else
+    {
+        tempBin = 1 + static_cast<int>(this->mNumberOfBins * (inValue - this->mLow) / (this->mHigh - this->mLow));
+    }
+    this->mContents[tempBin] += inWeight;
+}
+
+void HistogramBuffer::Merge(const HistogramBuffer& inBuffer)
+{
+    for (std::size_t i = 0; i < this->mContents.size() && i < inBuffer.mContents.size(); ++i)
+    {
+        this->mContents[i] += inBuffer.mContents[i];
+    }
+}
+
+void HistogramBuffer::AddTo(TH1& outHistogram) const
+{
+    for (int i = 0; i < this->mNumberOfBins + 2; ++i)
+    {
+        outHistogram.SetBinContent(i, outHistogram.GetBinContent(i) + this->mContents[i]);
+    }
+    outHistogram.ResetStats();
+}
+
+void HistogramBuffer::Reset()
+{
+    std::fill(this->mContents.begin(), this->mContents.end(), 0.0);
+}
+
+const std::vector<double>& HistogramBuffer::GetContents() const
+{
+    return this->mContents;
+}
+
+bool HistogramBuffer::SetContents(const std::vector<double>& inContents)
+{
+    if (inContents.size() != this->mContents.size())
+    {
+        return false;
+    }
+    this->mContents = inContents;
+    return true;
+}
+
+double HistogramBuffer::GetBinContent(int inBin) const
+{
+    return this->mContents[inBin];
+}
+
+int HistogramBuffer::GetNumberOfBins() const
+{
+    return this->mNumberOfBins;
+}
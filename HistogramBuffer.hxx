@@ -0,0 +1,99 @@
+#ifndef HISTOGRAMBUFFER_HXX
+#define HISTOGRAMBUFFER_HXX
+
+#include <TH1.h>
+
+#include <vector>
+
+/**
+ * @brief HistogramBuffer class
+ * @details HistogramBuffer is a plain array of bin contents with
+ * fixed binning, including underflow and overflow bins. \n
+ * Each thread fills its own buffer without lock, buffers are merged
+ * and copied to a TH1 at the end of the run.
+ * @date 2026-10-17
+ */
+class HistogramBuffer
+{
+    public:
+        /**
+         * @brief initializer
+         * @param int inNumberOfBins: number of bins
+         * @param double inLow: lower edge of first bin
+         * @param double inHigh: upper edge of last bin
+         */
+        HistogramBuffer(int inNumberOfBins, double inLow, double inHigh);
+
+        /**
+         * @brief initializer with binning of histogram
+         */
+        explicit HistogramBuffer(const TH1& inHistogram);
+
+        /**
+         * @brief fill value
+         * @details bin is found as by TAxis::FindBin, NaN goes to
+         * overflow. Sum of squared weights is not kept, errors of the
+         * histogram are sqrt(content) as for an unweighted TH1.
+         */
+        void Fill(double inValue, double inWeight = 1.0);
+
+        /**
+         * @brief add contents of other buffer with same binning
+         */
+        void Merge(const HistogramBuffer& inBuffer);
+
+        /**
+         * @brief add contents of this buffer to histogram with same binning
+         */
+        void AddTo(TH1& outHistogram) const;
+
+        /**
+         * @brief set all bin contents to 0
+         */
+        void Reset();
+
+        /**
+         * @brief get contents of all bins, including underflow and overflow
+         */
+        const std::vector<double>& GetContents() const;
+
+        /**
+         * @brief set contents of all bins, including underflow and overflow
+         * @return bool false if size of inContents is not GetNumberOfBins() + 2
+         */
+        bool SetContents(const std::vector<double>& inContents);
+
+        /**
+         * @brief get content of bin
+         * @param int inBin: 0 is underflow, GetNumberOfBins() + 1 is overflow
+         */
+        double GetBinContent(int inBin) const;
+
+        /**
+         * @brief get number of bins
+         */
+        int GetNumberOfBins() const;
+
+    private:
+        /**
+         * @brief number of bins
+         */
+        int mNumberOfBins;
+
+        /**
+         * @brief lower edge of first bin
+         */
+        double mLow;
+
+        /**
+         * @brief upper edge of last bin
+         */
+        double mHigh;
+
+        /**
+         * @brief bin contents, [0] underflow, [mNumberOfBins + 1] overflow
+         */
+        std::vector<double> mContents;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include "Logger.hxx"
+
+#include <utility>
+
+Logger::Logger(std::ostream& out, int inVerbosity)
+    : mOut(out)
+      ,mVerbosity(inVerbosity)
+{
+    this->mThread = std::thread(&Logger::WriteLoop, this);
+}
+
+Logger::~Logger()
+{
+    {
+        std::lock_guard<std::mutex> tempLock(this->mMutex);
+        this->mStop = true;
+    }
+    this->mQueued.notify_one();
+    this->mThread.join();
+}
+
+void Logger::Write(std::string&& inText)
+{
+    if (inText.empty())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> tempLock(this->mMutex);
+        this->mQueue.push_back(std::move(inText));
+    }
+    this->mQueued.notify_one();
+}
+
+void Logger::Write(std::ostringstream& inBuffer)
+{
+    if (inBuffer.tellp() <= 0)
+    {
+        return;
+    }
+    this->Write(inBuffer.str());
+    inBuffer.str("");
+}
+
+void Logger::Flush()
+{
+    std::unique_lock<std::mutex> tempLock(this->mMutex);
+    this->mWritten.wait(tempLock, [this]() { return this->mQueue.empty() && !this->mWriting; });
+}
+
+void Logger::WriteLoop()
+{
+    std::vector<std::string> tempMessages;
+    std::unique_lock<std::mutex> tempLock(this->mMutex);
+    while (true)
+    {
+        this->mQueued.wait(tempLock, [this]() { return !this->mQueue.empty() || this->mStop; });
+        if (this->mQueue.empty())
+        {
+            break;
+        }
+        // take the whole queue, workers keep queueing while it is written
+        tempMessages.swap(this->mQueue);
+        this->mWriting = true;
+        tempLock.unlock();
+        for (const std::string& tempMessage : tempMessages)
+        {
+            this->mOut << tempMessage;
+        }
+        this->mOut.flush();
+        tempMessages.clear();
+        tempLock.lock();
+        this->mWriting = false;
+        if (this->mQueue.empty())
+        {
+            this->mWritten.notify_all();
+        }
+    }
+    this->mWritten.notify_all();
+}
@@ -0,0 +1,131 @@
+#ifndef LOGGER_HXX
+#define LOGGER_HXX
+
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Logger class
+ * @details Logger writes text reports of the event loop to an output
+ * stream from a background thread. \n
+ * Each worker formats its messages into its own std::ostringstream,
+ * only if IsEnabled() of the message level is true, and hands the
+ * buffer over with Write(). Writing to the terminal or to disk is done
+ * by the writer thread, so workers do not wait for it.
+ * @date 2026-10-17
+ */
+class Logger
+{
+    public:
+        /**
+         * @brief verbosity level
+         * @details a message of level L is written if L <= verbosity.
+         */
+        enum Level
+        {
+            kSilent = 0,
+            kError,
+            kEvent,
+            kObjects
+        };
+
+        /**
+         * @brief initializer
+         * @details writer thread is started here.
+         * @param std::ostream& out: output stream, used only by the writer thread
+         * @param int inVerbosity: messages up to this level are written
+         */
+        Logger(std::ostream& out, int inVerbosity);
+
+        /**
+         * @brief write pending messages and stop the writer thread
+         */
+        ~Logger();
+
+        Logger(const Logger&) = delete;
+        Logger& operator=(const Logger&) = delete;
+
+        /**
+         * @brief check if messages of level are written
+         * @details messages of a disabled level should not be formatted.
+         */
+        bool IsEnabled(Level inLevel) const
+        {
+            return inLevel <= this->mVerbosity;
+        };
+
+        /**
+         * @brief queue text for the writer thread
+         */
+        void Write(std::string&& inText);
+
+        /**
+         * @brief queue contents of buffer for the writer thread
+         * @details buffer is cleared and can be reused.
+         */
+        void Write(std::ostringstream& inBuffer);
+
+        /**
+         * @brief wait until all queued messages are written
+         * @details output stream is flushed.
+         */
+        void Flush();
+
+    private:
+        /**
+         * @brief loop of the writer thread
+         */
+        void WriteLoop();
+
+        /**
+         * @brief output stream
+         */
+        std::ostream& mOut;
+
+        /**
+         * @brief verbosity
+         */
+        int mVerbosity = kObjects;
+
+        /**
+         * @brief lock of queue and flags
+         */
+        std::mutex mMutex;
+
+        /**
+         * @brief signals new messages or stop to the writer thread
+         */
+        std::condition_variable mQueued;
+
+        /**
+         * @brief signals that the queue is written
+         */
+        std::condition_variable mWritten;
+
+        /**
+         * @brief messages not taken by the writer thread yet
+         */
+        std::vector<std::string> mQueue;
+
+        /**
+         * @brief writer thread is writing messages taken from the queue
+         */
+        bool mWriting = false;
+
+        /**
+         * @brief writer thread should stop when the queue is empty
+         */
+        bool mStop = false;
+
+        /**
+         * @brief writer thread
+         */
+        std::thread mThread;
+};
+
+#endif
@@ -0,0 +1,208 @@
+#include "ObjectSnapshot.hxx"
+
+#include <limits>
+
+void ObjectSnapshot::Clear()
+{
+    this->mX.clear();
+    this->mY.clear();
+    this->mZ.clear();
+    this->mT.clear();
+    this->mKind.clear();
+    this->mTrajectoryId.clear();
+    this->mPdg.clear();
+    this->mParentId.clear();
+    this->mParentPdg.clear();
+    this->mPrimaryId.clear();
+    this->mAncestorFlags.clear();
+}
+
+void ObjectSnapshot::Reserve(std::size_t inSize)
+{
+    this->mX.reserve(inSize);
+    this->mY.reserve(inSize);
+    this->mZ.reserve(inSize);
+    this->mT.reserve(inSize);
+    this->mKind.reserve(inSize);
+    this->mTrajectoryId.reserve(inSize);
+    this->mPdg.reserve(inSize);
+    this->mParentId.reserve(inSize);
+    this->mParentPdg.reserve(inSize);
+    this->mPrimaryId.reserve(inSize);
+    this->mAncestorFlags.reserve(inSize);
+}
+
+void ObjectSnapshot::Add(const TLorentzVector& inPosition, int inKind, int inTrajectoryId,
+        const TruthIndex::TrajectoryInfo* inInfo, int inParentPdg)
+{
+    this->mX.push_back(inPosition.X());
+    this->mY.push_back(inPosition.Y());
+    this->mZ.push_back(inPosition.Z());
+    this->mT.push_back(inKind == kOther ? std::numeric_limits<double>::infinity() : inPosition.T());
+    this->mKind.push_back(inKind);
+    this->mTrajectoryId.push_back(inTrajectoryId);
+    this->mPdg.push_back(inInfo ? inInfo->pdg : 0);
+    this->mParentId.push_back(inInfo ? inInfo->parentId : 0);
+    this->mParentPdg.push_back(inParentPdg);
+    this->mPrimaryId.push_back(inInfo ? inInfo->primaryId : TruthIndex::kNoTrajectory);
+    this->mAncestorFlags.push_back(inInfo ? inInfo->ancestorFlags : 0u);
+}
+
+std::size_t ObjectSnapshot::GetSize() const
+{
+    return this->mT.size();
+}
+
+const std::vector<double>& ObjectSnapshot::GetX() const
+{
+    return this->mX;
+}
+
+const std::vector<double>& ObjectSnapshot::GetY() const
+{
+    return this->mY;
+}
+
+const std::vector<double>& ObjectSnapshot::GetZ() const
+{
+    return this->mZ;
+}
+
+const std::vector<double>& ObjectSnapshot::GetT() const
+{
+    return this->mT;
+}
+
+const std::vector<int>& ObjectSnapshot::GetKind() const
+{
+    return this->mKind;
+}
+
+const std::vector<int>& ObjectSnapshot::GetTrajectoryId() const
+{
+    return this->mTrajectoryId;
+}
+
+const std::vector<int>& ObjectSnapshot::GetPdg() const
+{
+    return this->mPdg;
+}
+
+const std::vector<int>& ObjectSnapshot::GetParentId() const
+{
+    return this->mParentId;
+}
+
+const std::vector<int>& ObjectSnapshot::GetParentPdg() const
+{
+    return this->mParentPdg;
+}
+
+const std::vector<int>& ObjectSnapshot::GetPrimaryId() const
+{
+    return this->mPrimaryId;
+}
+
+const std::vector<unsigned int>& ObjectSnapshot::GetAncestorFlags() const
+{
+    return this->mAncestorFlags;
+}
+
+TLorentzVector ObjectSnapshot::GetPosition(int inIndex) const
+{
+    if (inIndex < 0 || this->mKind[inIndex] == kOther)
+    {
+        return TLorentzVector();
+    }
+    return TLorentzVector(this->mX[inIndex], this->mY[inIndex], this->mZ[inIndex], this->mT[inIndex]);
+}
+
+void ObjectSnapshot::SelectFirstObjectCandidates(std::vector<unsigned char>& outMask) const
+{
+    static const std::vector<int> tempRejectedPdgs = {-13, 0};
+    outMask.resize(this->GetSize());
+    SelectFirstObjectCandidates(this->mPdg.data(), this->mAncestorFlags.data(), this->GetSize(),
+            tempRejectedPdgs, TruthIndex::kMuonAncestor, outMask.data());
+}
+
+void ObjectSnapshot::SelectFirstObjectCandidates(const int* inPdg, const unsigned int* inAncestorFlags,
+        std::size_t inSize, const std::vector<int>& inRejectedPdgs, unsigned int inRejectedAncestors,
+        unsigned char* outMask)
+{
+    const int* __restrict pdg = inPdg;
+    const unsigned int* __restrict ancestorFlags = inAncestorFlags;
+    unsigned char* __restrict mask = outMask;
+    // unsigned int, not bool: gcc does not vectorize int compares to a char mask
+    for (std::size_t i = 0; i < inSize; ++i)
+    {
+        mask[i] = (ancestorFlags[i] & inRejectedAncestors) == 0 ? 1u : 0u;
+    }
+    for (int tempRejectedPdg : inRejectedPdgs)
+    {
+        for (std::size_t i = 0; i < inSize; ++i)
+        {
+            mask[i] &= pdg[i] != tempRejectedPdg ? 1u : 0u;
+        }
+    }
+}
+
+void ObjectSnapshot::SelectTracks(int inPdg, std::vector<unsigned char>& outMask) const
+{
+    const std::size_t tempSize = this->GetSize();
+    outMask.resize(tempSize);
+    const int* __restrict kind = this->mKind.data();
+    const int* __restrict pdg = this->mPdg.data();
+    unsigned char* __restrict mask = outMask.data();
+    for (std::size_t i = 0; i < tempSize; ++i)
+    {
+        mask[i] = (kind[i] == kTrack) & (pdg[i] == inPdg);
+    }
+}
+
+int ObjectSnapshot::CountPrimaryTracks(int inPdg) const
+{
+    const std::size_t tempSize = this->GetSize();
+    const int* __restrict kind = this->mKind.data();
+    const int* __restrict pdg = this->mPdg.data();
+    const int* __restrict parentId = this->mParentId.data();
+    int tempCount = 0;
+    for (std::size_t i = 0; i < tempSize; ++i)
+    {
+        tempCount += (kind[i] == kTrack) & (pdg[i] == inPdg) & (parentId[i] == -1);
+    }
+    return tempCount;
+}
+
+int ObjectSnapshot::FindEarliest(const std::vector<unsigned char>& inMask) const
+{
+    return FindEarliest(this->mT.data(), inMask.data(), this->GetSize());
+}
+
+int ObjectSnapshot::FindEarliest(const double* inT, const unsigned char* inMask, std::size_t inSize)
+{
+    const double tempInfinity = std::numeric_limits<double>::infinity();
+    const double* __restrict t = inT;
+    const unsigned char* __restrict mask = inMask;
+
+    // first pass: minimum time of selected objects, branch free
+    double tempMinimum = tempInfinity;
+    for (std::size_t i = 0; i < inSize; ++i)
+    {
+        const double tempTime = mask[i] ? t[i] : tempInfinity;
+        tempMinimum = tempTime < tempMinimum ? tempTime : tempMinimum;
+    }
+    if (!(tempMinimum < tempInfinity))
+    {
+        return -1;
+    }
+
+    // second pass: first selected object at that time
+    for (std::size_t i = 0; i < inSize; ++i)
+    {
+        if (mask[i] && t[i] == tempMinimum)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
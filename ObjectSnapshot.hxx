@@ -0,0 +1,160 @@
+#ifndef OBJECTSNAPSHOT_HXX
+#define OBJECTSNAPSHOT_HXX
+
+#include "TruthIndex.hxx"
+
+#include <TLorentzVector.h>
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief ObjectSnapshot class
+ * @details ObjectSnapshot has position, kind and truth information
+ * (including ancestry) of all reconstructed objects of an event as structure of arrays. \n
+ * It is built once per event, row i is object i of the object container,
+ * so consumers read contiguous columns instead of casting Cube::Handle
+ * and calling GetPosition() for every object. \n
+ * Kernels are plain loops over the columns without branches on object
+ * type. In an optimized build the selection and counting loops are
+ * vectorized by the compiler, the minimum of FindEarliest is not: a
+ * floating point reduction is vectorized only with -ffast-math, which
+ * this build does not use.
+ * @date 2026-10-17
+ */
+class ObjectSnapshot
+{
+    public:
+        /**
+         * @brief kind of object
+         */
+        enum Kind
+        {
+            kOther = 0,
+            kTrack = 1,
+            kCluster = 2
+        };
+
+        /**
+         * @brief remove all rows
+         * @details columns keep their capacity for the next event.
+         */
+        void Clear();
+
+        /**
+         * @brief reserve memory of all columns
+         */
+        void Reserve(std::size_t inSize);
+
+        /**
+         * @brief add one object
+         * @param const TLorentzVector& inPosition: (x, y, z, t) of object
+         * @param int inKind: Kind of object
+         * @param int inTrajectoryId: main trajectory id of object
+         * @param const TruthIndex::TrajectoryInfo* inInfo: truth information
+         * of main trajectory, NULL if not matched
+         * @param int inParentPdg: pdg code of parent trajectory
+         */
+        void Add(const TLorentzVector& inPosition, int inKind, int inTrajectoryId,
+                const TruthIndex::TrajectoryInfo* inInfo, int inParentPdg);
+
+        /**
+         * @brief get number of objects
+         */
+        std::size_t GetSize() const;
+
+        /**
+         * @brief get column, one entry per object
+         */
+        const std::vector<double>& GetX() const;
+        const std::vector<double>& GetY() const;
+        const std::vector<double>& GetZ() const;
+        const std::vector<double>& GetT() const;
+        const std::vector<int>& GetKind() const;
+        const std::vector<int>& GetTrajectoryId() const;
+        const std::vector<int>& GetPdg() const;
+        const std::vector<int>& GetParentId() const;
+        const std::vector<int>& GetParentPdg() const;
+        const std::vector<int>& GetPrimaryId() const;
+        const std::vector<unsigned int>& GetAncestorFlags() const;
+
+        /**
+         * @brief get (x, y, z, t) of object
+         * @param int inIndex: row of object
+         */
+        TLorentzVector GetPosition(int inIndex) const;
+
+        /**
+         * @brief select objects which can be first object
+         * @details not anti muon, matched to a trajectory and not a
+         * descendant of a muon (at any generation).
+         * @param std::vector<unsigned char>& outMask: 1 if selected, one per row
+         */
+        void SelectFirstObjectCandidates(std::vector<unsigned char>& outMask) const;
+
+        /**
+         * @brief select rows which can be first object
+         * @details kernel of SelectFirstObjectCandidates() on columns of
+         * any owner, EventStore runs it on the rows of each event.
+         * @param const int* inPdg: pdg column
+         * @param const unsigned int* inAncestorFlags: ancestor flags column
+         * @param std::size_t inSize: number of rows
+         * @param const std::vector<int>& inRejectedPdgs: pdg codes which cannot be first object
+         * @param unsigned int inRejectedAncestors: TruthIndex::AncestorFlag of
+         * rows which cannot be first object
+         * @param unsigned char* outMask: 1 if selected, inSize values
+         */
+        static void SelectFirstObjectCandidates(const int* inPdg, const unsigned int* inAncestorFlags,
+                std::size_t inSize, const std::vector<int>& inRejectedPdgs, unsigned int inRejectedAncestors,
+                unsigned char* outMask);
+
+        /**
+         * @brief select tracks of given pdg code
+         * @param std::vector<unsigned char>& outMask: 1 if selected, one per row
+         */
+        void SelectTracks(int inPdg, std::vector<unsigned char>& outMask) const;
+
+        /**
+         * @brief count primary tracks of given pdg code
+         */
+        int CountPrimaryTracks(int inPdg) const;
+
+        /**
+         * @brief find earliest selected object
+         * @details ties are broken by row, so the result is the first
+         * selected object of the time ordered objects. Objects which are
+         * neither track nor cluster have infinite time and are never found.
+         * @param const std::vector<unsigned char>& inMask: selection, one per row
+         * @return int row of earliest selected object, -1 if none is selected
+         */
+        int FindEarliest(const std::vector<unsigned char>& inMask) const;
+
+        /**
+         * @brief find earliest selected row
+         * @details kernel of FindEarliest() on columns of any owner.
+         * @param const double* inT: time column, infinite for rows which
+         * are neither track nor cluster
+         * @param const unsigned char* inMask: selection, inSize values
+         * @param std::size_t inSize: number of rows
+         * @return int row of earliest selected row of finite time, -1 if none
+         */
+        static int FindEarliest(const double* inT, const unsigned char* inMask, std::size_t inSize);
+
+    private:
+        /**
+         * @brief columns of objects, row i is object i of the container
+         */
+        std::vector<double> mX;
+        std::vector<double> mY;
+        std::vector<double> mZ;
+        std::vector<double> mT;
+        std::vector<int> mKind;
+        std::vector<int> mTrajectoryId;
+        std::vector<int> mPdg;
+        std::vector<int> mParentId;
+        std::vector<int> mParentPdg;
+        std::vector<int> mPrimaryId;
+        std::vector<unsigned int> mAncestorFlags;
+};
+
+#endif
@@ -0,0 +1,159 @@
+#include "RunStatistics.hxx"
+
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+    double ToSeconds(std::chrono::steady_clock::duration inTime)
+    {
+        return std::chrono::duration<double>(inTime).count();
+    }
+}
+
+void RunStatistics::AddTime(Stage inStage, std::chrono::steady_clock::duration inTime)
+{
+    this->mTime[inStage] += inTime;
+}
+
+void RunStatistics::Pass(Cut inCut)
+{
+    this->mPassed[inCut]++;
+}
+
+void RunStatistics::AddPassed(Cut inCut, Long64_t inNumberOfEvents)
+{
+    this->mPassed[inCut] += inNumberOfEvents;
+}
+
+Long64_t RunStatistics::GetPassed(Cut inCut) const
+{
+    return this->mPassed[inCut];
+}
+
+void RunStatistics::AddBytes(Long64_t inBytes)
+{
+    this->mBytesRead += inBytes;
+}
+
+void RunStatistics::Merge(const RunStatistics& inStatistics)
+{
+    for (int i = 0; i < kNumberOfStages; ++i)
+    {
+        this->mTime[i] += inStatistics.mTime[i];
+    }
+    for (int i = 0; i < kNumberOfCuts; ++i)
+    {
+        this->mPassed[i] += inStatistics.mPassed[i];
+    }
+    this->mBytesRead += inStatistics.mBytesRead;
+}
+
+const char* RunStatistics::GetStageName(Stage inStage)
+{
+    switch (inStage)
+    {
+        case kGetEntry: return "GetEntry";
+        case kTruthCounters: return "SetTruthCounters";
+        case kCollectObjects: return "CollectObjects";
+        case kAntiMuonObjects: return "SetNumberOfPrimaryAntiMuonObject";
+        case kVertex: return "SetVertex";
+        case kFirstObject: return "SetFirstObject";
+        case kDeltaT: return "delta T histograms";
+        case kOutput: return "output";
+        default: return "unknown";
+    }
+}
+
+const char* RunStatistics::GetCutName(Cut inCut)
+{
+    switch (inCut)
+    {
+        case kRead: return "read";
+        case kTrueCC0pi: return "true CC0pi";
+        case kObjectContainer: return "object container";
+        case kSingleAntiMuonObject: return "single anti muon object";
+        case kVertexCandidate: return "vertex candidate";
+        case kFirstObjectCandidate: return "first object candidate";
+        default: return "unknown";
+    }
+}
+
+void RunStatistics::Print(std::ostream& out, double inWallTime, Long64_t inFileBytesRead) const
+{
+    char tempLine[256];
+    out << "================ cut flow ================" << "\n";
+    std::snprintf(tempLine, sizeof(tempLine), "%-28s %12s %12s %10s\n", "cut", "entering", "passing", "fraction");
+    out << tempLine;
+    for (int i = 0; i < kNumberOfCuts; ++i)
+    {
+        const Long64_t tempEntering = (i == 0) ? this->mPassed[0] : this->mPassed[i - 1];
+        std::snprintf(tempLine, sizeof(tempLine), "%-28s %12lld %12lld %10.4f\n",
+                GetCutName(static_cast<Cut>(i)),
+                static_cast<long long>(tempEntering),
+                static_cast<long long>(this->mPassed[i]),
+                tempEntering > 0 ? static_cast<double>(this->mPassed[i]) / tempEntering : 0.0);
+        out << tempLine;
+    }
+
+    double tempTotalStageTime = 0;
+    for (int i = 0; i < kNumberOfStages; ++i)
+    {
+        tempTotalStageTime += ToSeconds(this->mTime[i]);
+    }
+    out << "================ timing ==================" << "\n";
+    std::snprintf(tempLine, sizeof(tempLine), "%-34s %12s %14s %10s\n", "stage", "time [s]", "per event [us]", "fraction");
+    out << tempLine;
+    for (int i = 0; i < kNumberOfStages; ++i)
+    {
+        const double tempTime = ToSeconds(this->mTime[i]);
+        std::snprintf(tempLine, sizeof(tempLine), "%-34s %12.3f %14.3f %10.4f\n",
+                GetStageName(static_cast<Stage>(i)),
+                tempTime,
+                this->mPassed[kRead] > 0 ? 1e6 * tempTime / this->mPassed[kRead] : 0.0,
+                tempTotalStageTime > 0 ? tempTime / tempTotalStageTime : 0.0);
+        out << tempLine;
+    }
+    out << "wall time [s]: " << inWallTime << "\n";
+    out << "bytes read (uncompressed): " << this->mBytesRead << "\n";
+    out << "bytes read (from files): " << inFileBytesRead << "\n";
+    if (inWallTime > 0)
+    {
+        out << "throughput: " << this->mPassed[kRead] / inWallTime << " events/s, "
+            << this->mBytesRead / inWallTime / 1e6 << " MB/s" << "\n";
+    }
+    out << "==========================================" << std::endl;
+}
+
+bool RunStatistics::WriteJson(const std::string& inFileName, double inWallTime, Long64_t inFileBytesRead) const
+{
+    std::ofstream out(inFileName);
+    if (!out)
+    {
+        return false;
+    }
+    out << "{\n";
+    out << "  \"wallTime\": " << inWallTime << ",\n";
+    out << "  \"bytesRead\": " << this->mBytesRead << ",\n";
+    out << "  \"fileBytesRead\": " << inFileBytesRead << ",\n";
+    out << "  \"eventsPerSecond\": " << (inWallTime > 0 ? this->mPassed[kRead] / inWallTime : 0.0) << ",\n";
+    out << "  \"cutFlow\": [\n";
+    for (int i = 0; i < kNumberOfCuts; ++i)
+    {
+        out << "    {\"cut\": \"" << GetCutName(static_cast<Cut>(i))
+            << "\", \"entering\": " << ((i == 0) ? this->mPassed[0] : this->mPassed[i - 1])
+            << ", \"passing\": " << this->mPassed[i] << "}"
+            << (i + 1 < kNumberOfCuts ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"stages\": [\n";
+    for (int i = 0; i < kNumberOfStages; ++i)
+    {
+        out << "    {\"stage\": \"" << GetStageName(static_cast<Stage>(i))
+            << "\", \"time\": " << ToSeconds(this->mTime[i]) << "}"
+            << (i + 1 < kNumberOfStages ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+    return static_cast<bool>(out);
+}
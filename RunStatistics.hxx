@@ -0,0 +1,166 @@
+#ifndef RUNSTATISTICS_HXX
+#define RUNSTATISTICS_HXX
+
+#include <Rtypes.h>
+
+#include <chrono>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief RunStatistics class
+ * @details RunStatistics has per stage wall time, cut flow counters and
+ * bytes read of the event loop. \n
+ * Each worker fills its own RunStatistics, they are merged at the end
+ * of the run. \n
+ * Statistics are filled through the RUN_STATISTICS_* macros, which are
+ * empty unless TEST_ANALYSIS_INSTRUMENTATION is defined.
+ * @date 2026-10-17
+ */
+class RunStatistics
+{
+    public:
+        /**
+         * @brief timed stage of the event loop
+         */
+        enum Stage
+        {
+            kGetEntry = 0,
+            kTruthCounters,
+            kCollectObjects,
+            kAntiMuonObjects,
+            kVertex,
+            kFirstObject,
+            kDeltaT,
+            kOutput,
+            kNumberOfStages
+        };
+
+        /**
+         * @brief cut of the event loop
+         * @details number of events entering a cut is number of events
+         * passing the previous one.
+         */
+        enum Cut
+        {
+            kRead = 0,
+            kTrueCC0pi,
+            kObjectContainer,
+            kSingleAntiMuonObject,
+            kVertexCandidate,
+            kFirstObjectCandidate,
+            kNumberOfCuts
+        };
+
+        /**
+         * @brief RAII timer of a stage
+         */
+        class StageTimer
+        {
+            public:
+                StageTimer(RunStatistics& inStatistics, Stage inStage)
+                    : mStatistics(inStatistics)
+                      ,mStage(inStage)
+                      ,mStart(std::chrono::steady_clock::now())
+                {
+                };
+
+                ~StageTimer()
+                {
+                    mStatistics.AddTime(mStage, std::chrono::steady_clock::now() - mStart);
+                };
+
+            private:
+                RunStatistics& mStatistics;
+                Stage mStage;
+                std::chrono::steady_clock::time_point mStart;
+        };
+
+        /**
+         * @brief add wall time to stage
+         */
+        void AddTime(Stage inStage, std::chrono::steady_clock::duration inTime);
+
+        /**
+         * @brief count one event passing cut
+         */
+        void Pass(Cut inCut);
+
+        /**
+         * @brief count events passing cut
+         * @details used to restore the cut flow of a checkpoint.
+         */
+        void AddPassed(Cut inCut, Long64_t inNumberOfEvents);
+
+        /**
+         * @brief get number of events passing cut
+         */
+        Long64_t GetPassed(Cut inCut) const;
+
+        /**
+         * @brief add bytes read by TTree::GetEntry
+         */
+        void AddBytes(Long64_t inBytes);
+
+        /**
+         * @brief add other statistics to this
+         */
+        void Merge(const RunStatistics& inStatistics);
+
+        /**
+         * @brief print cut flow and timing table
+         * @param std::ostream& out: output stream
+         * @param double inWallTime: wall time of the run in seconds
+         * @param Long64_t inFileBytesRead: compressed bytes read from files
+         */
+        void Print(std::ostream& out, double inWallTime, Long64_t inFileBytesRead) const;
+
+        /**
+         * @brief write machine readable report
+         * @param const std::string& inFileName: output JSON file name
+         * @return bool false if file cannot be written
+         */
+        bool WriteJson(const std::string& inFileName, double inWallTime, Long64_t inFileBytesRead) const;
+
+        /**
+         * @brief get name of stage
+         */
+        static const char* GetStageName(Stage inStage);
+
+        /**
+         * @brief get name of cut
+         */
+        static const char* GetCutName(Cut inCut);
+
+    private:
+        /**
+         * @brief wall time of each stage, summed over workers
+         */
+        std::chrono::steady_clock::duration mTime[kNumberOfStages] = {};
+
+        /**
+         * @brief number of events passing each cut
+         */
+        Long64_t mPassed[kNumberOfCuts] = {};
+
+        /**
+         * @brief uncompressed bytes read by TTree::GetEntry
+         */
+        Long64_t mBytesRead = 0;
+};
+
+#define RUN_STATISTICS_CONCAT_(a, b) a##b
+#define RUN_STATISTICS_CONCAT(a, b) RUN_STATISTICS_CONCAT_(a, b)
+
+#ifdef TEST_ANALYSIS_INSTRUMENTATION
+#define RUN_STATISTICS_TIMER(statistics, stage) \
+    RunStatistics::StageTimer RUN_STATISTICS_CONCAT(runStatisticsTimer, __LINE__)(statistics, stage)
+#define RUN_STATISTICS_PASS(statistics, cut) (statistics).Pass(cut)
+#define RUN_STATISTICS_BYTES(statistics, bytes) (statistics).AddBytes(bytes)
+#else
+#define RUN_STATISTICS_TIMER(statistics, stage) do {} while (0)
+#define RUN_STATISTICS_PASS(statistics, cut) do {} while (0)
+#define RUN_STATISTICS_BYTES(statistics, bytes) ((void)(bytes))
+#endif
+
+#endif
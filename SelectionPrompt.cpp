@@ -0,0 +1,308 @@
+#include "SelectionPrompt.hxx"
+#include "StringUtility.hxx"
+
+#include <TFile.h>
+#include <TH1.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+    /**
+     * @brief get TruthIndex::AncestorFlag of name
+     * @return unsigned int 0 if name is unknown
+     */
+    unsigned int GetAncestorFlag(const std::string& inName)
+    {
+        if (inName == "muon") return TruthIndex::kMuonAncestor;
+        if (inName == "neutron") return TruthIndex::kNeutronAncestor;
+        if (inName == "proton") return TruthIndex::kProtonAncestor;
+        if (inName == "pion") return TruthIndex::kPionAncestor;
+        if (inName == "gamma") return TruthIndex::kGammaAncestor;
+        if (inName == "electron") return TruthIndex::kElectronAncestor;
+        return 0;
+    }
+
+    /**
+     * @brief get mean of bin centers of buffer, underflow and overflow excluded
+     */
+    double GetMean(const HistogramBuffer& inBuffer, double inLow, double inHigh)
+    {
+        const int tempNumberOfBins = inBuffer.GetNumberOfBins();
+        const double tempWidth = (inHigh - inLow) / tempNumberOfBins;
+        double tempSum = 0;
+        double tempSumOfWeights = 0;
+        for (int i = 1; i <= tempNumberOfBins; ++i)
+        {
+            tempSum += inBuffer.GetBinContent(i) * (inLow + (i - 0.5) * tempWidth);
+            tempSumOfWeights += inBuffer.GetBinContent(i);
+        }
+        return tempSumOfWeights > 0 ? tempSum / tempSumOfWeights : 0;
+    }
+}
+
+SelectionPrompt::SelectionPrompt(const EventStore& inStore, int inNumberOfThreads)
+    : mStore(inStore)
+      ,mNumberOfThreads(inNumberOfThreads)
+{
+    if (this->mNumberOfThreads <= 0)
+    {
+        this->mNumberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+const EventStore::Selection& SelectionPrompt::GetSelection() const
+{
+    return this->mSelection;
+}
+
+bool SelectionPrompt::Run(std::istream& in, std::ostream& out, bool inInteractive)
+{
+    bool tempSuccess = true;
+    std::string tempLine;
+    this->mQuit = false;
+    while (!this->mQuit)
+    {
+        if (inInteractive)
+        {
+            out << "selection> " << std::flush;
+        }
+        if (!std::getline(in, tempLine))
+        {
+            break;
+        }
+        if (!inInteractive)
+        {
+            out << "> " << tempLine << "\n";
+        }
+        if (!this->RunCommand(tempLine, out))
+        {
+            tempSuccess = false;
+        }
+    }
+    out.flush();
+    return tempSuccess;
+}
+
+bool SelectionPrompt::RunCommand(const std::string& inCommand, std::ostream& out)
+{
+    std::istringstream tempArguments(inCommand.substr(0, inCommand.find('#')));
+    std::string tempCommand;
+    if (!(tempArguments >> tempCommand))
+    {
+        return true;
+    }
+
+    if (tempCommand == "set")
+    {
+        return this->Set(tempArguments, out);
+    }
+    else if (tempCommand == "reset")
+    {
+        this->mSelection = EventStore::Selection();
+        this->Show(out);
+    }
+    else if (tempCommand == "show")
+    {
+        this->Show(out);
+    }
+    else if (tempCommand == "count")
+    {
+        const std::chrono::steady_clock::time_point tempStart = std::chrono::steady_clock::now();
+        const EventStore::Result tempResult = this->mStore.Select(this->mSelection, this->mNumberOfThreads);
+        this->ShowCutFlow(tempResult,
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - tempStart).count(), out);
+    }
+    else if (tempCommand == "hist")
+    {
+        return this->Histogram(tempArguments, out);
+    }
+    else if (tempCommand == "help")
+    {
+        Help(out);
+    }
+    else if (tempCommand == "quit" || tempCommand == "exit")
+    {
+        this->mQuit = true;
+    }
+    else
+    {
+        out << "unknown command: " << tempCommand << ", try help\n";
+        return false;
+    }
+    return true;
+}
+
+bool SelectionPrompt::Set(std::istream& inArguments, std::ostream& out)
+{
+    std::string tempCut;
+    std::string tempValue;
+    if (!(inArguments >> tempCut >> tempValue))
+    {
+        out << "usage: set CUT VALUE\n";
+        return false;
+    }
+
+    if (tempCut == "pions" || tempCut == "antimuons" || tempCut == "antimuonobjects")
+    {
+        int tempNumber = 0;
+        if (std::sscanf(tempValue.c_str(), "%d", &tempNumber) != 1 || tempNumber < 0)
+        {
+            out << "invalid number: " << tempValue << "\n";
+            return false;
+        }
+        int& tempTarget = tempCut == "pions" ? this->mSelection.maxPrimaryPions
+            : (tempCut == "antimuons" ? this->mSelection.primaryAntiMuons : this->mSelection.primaryAntiMuonObjects);
+        tempTarget = tempNumber;
+    }
+    else if (tempCut == "reject")
+    {
+        std::vector<int> tempPdgs;
+        for (const std::string& tempItem : SplitList(tempValue))
+        {
+            int tempPdg = 0;
+            if (tempItem != "none" && std::sscanf(tempItem.c_str(), "%d", &tempPdg) != 1)
+            {
+                out << "invalid pdg code: " << tempItem << "\n";
+                return false;
+            }
+            if (tempItem != "none")
+            {
+                tempPdgs.push_back(tempPdg);
+            }
+        }
+        this->mSelection.rejectedPdgs = tempPdgs;
+    }
+    else if (tempCut == "ancestors")
+    {
+        unsigned int tempFlags = 0;
+        for (const std::string& tempItem : SplitList(tempValue))
+        {
+            const unsigned int tempFlag = GetAncestorFlag(tempItem);
+            if (tempFlag == 0 && tempItem != "none")
+            {
+                out << "invalid ancestor: " << tempItem << "\n";
+                return false;
+            }
+            tempFlags |= tempFlag;
+        }
+        this->mSelection.rejectedAncestors = tempFlags;
+    }
+    else
+    {
+        out << "unknown cut: " << tempCut << ", try help\n";
+        return false;
+    }
+    this->Show(out);
+    return true;
+}
+
+bool SelectionPrompt::Histogram(std::istream& inArguments, std::ostream& out)
+{
+    std::string tempVariableName;
+    int tempNumberOfBins = 0;
+    double tempLow = 0;
+    double tempHigh = 0;
+    if (!(inArguments >> tempVariableName >> tempNumberOfBins >> tempLow >> tempHigh)
+            || tempNumberOfBins <= 0 || tempHigh <= tempLow
+            || (tempVariableName != "deltaT" && tempVariableName != "distance"))
+    {
+        out << "usage: hist deltaT|distance NBINS LOW HIGH [FILE]\n";
+        return false;
+    }
+    std::string tempFileName;
+    inArguments >> tempFileName;
+    const EventStore::Variable tempVariable = tempVariableName == "deltaT" ? EventStore::kDeltaT : EventStore::kDistance;
+
+    HistogramBuffer tempNeutron(tempNumberOfBins, tempLow, tempHigh);
+    HistogramBuffer tempOther(tempNumberOfBins, tempLow, tempHigh);
+    const std::chrono::steady_clock::time_point tempStart = std::chrono::steady_clock::now();
+    const EventStore::Result tempResult = this->mStore.Select(this->mSelection, this->mNumberOfThreads,
+            tempVariable, &tempNeutron, &tempOther);
+    this->ShowCutFlow(tempResult,
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - tempStart).count(), out);
+    out << tempVariableName << " mean, neutron: " << GetMean(tempNeutron, tempLow, tempHigh)
+        << ", other: " << GetMean(tempOther, tempLow, tempHigh)
+        << " (underflow " << tempNeutron.GetBinContent(0) + tempOther.GetBinContent(0)
+        << ", overflow " << tempNeutron.GetBinContent(tempNumberOfBins + 1) + tempOther.GetBinContent(tempNumberOfBins + 1)
+        << ")\n";
+
+    if (tempFileName.empty())
+    {
+        return true;
+    }
+    std::unique_ptr<TFile> tempFile(TFile::Open(tempFileName.c_str(), "UPDATE"));
+    if (!tempFile || tempFile->IsZombie())
+    {
+        out << "cannot open " << tempFileName << "\n";
+        return false;
+    }
+    TH1F tempNeutronHistogram("", (tempVariableName + ", neutron").c_str(), tempNumberOfBins, tempLow, tempHigh);
+    TH1F tempOtherHistogram("", (tempVariableName + ", other").c_str(), tempNumberOfBins, tempLow, tempHigh);
+    tempNeutronHistogram.SetDirectory(NULL);
+    tempOtherHistogram.SetDirectory(NULL);
+    tempNeutron.AddTo(tempNeutronHistogram);
+    tempOther.AddTo(tempOtherHistogram);
+    tempFile->WriteTObject(&tempNeutronHistogram, (tempVariableName + "Neutron").c_str(), "Overwrite");
+    tempFile->WriteTObject(&tempOtherHistogram, (tempVariableName + "Other").c_str(), "Overwrite");
+    tempFile->Close();
+    out << "histograms written to " << tempFileName << "\n";
+    return true;
+}
+
+void SelectionPrompt::Show(std::ostream& out) const
+{
+    out << "pions <= " << this->mSelection.maxPrimaryPions
+        << ", antimuons = " << this->mSelection.primaryAntiMuons
+        << ", antimuonobjects = " << this->mSelection.primaryAntiMuonObjects
+        << ", reject:";
+    for (int tempPdg : this->mSelection.rejectedPdgs)
+    {
+        out << " " << tempPdg;
+    }
+    out << ", ancestors:";
+    for (const char* tempName : {"muon", "neutron", "proton", "pion", "gamma", "electron"})
+    {
+        if (this->mSelection.rejectedAncestors & GetAncestorFlag(tempName))
+        {
+            out << " " << tempName;
+        }
+    }
+    out << "\n";
+}
+
+void SelectionPrompt::ShowCutFlow(const EventStore::Result& inResult, double inSeconds, std::ostream& out) const
+{
+    for (int i = 0; i < RunStatistics::kNumberOfCuts; ++i)
+    {
+        char tempLine[128];
+        std::snprintf(tempLine, sizeof(tempLine), "%-26s %12lld\n",
+                RunStatistics::GetCutName(static_cast<RunStatistics::Cut>(i)),
+                static_cast<long long>(inResult.passed[i]));
+        out << tempLine;
+    }
+    out << "first object from neutron: " << inResult.neutron
+        << " (" << this->mStore.GetNumberOfEvents() << " events in " << inSeconds << " s)\n";
+}
+
+void SelectionPrompt::Help(std::ostream& out)
+{
+    out << "set pions N                 maximum number of primary pions (true)\n"
+        << "set antimuons N             number of primary anti muons (true)\n"
+        << "set antimuonobjects N       number of primary anti muon objects\n"
+        << "set reject P1,P2,...        pdg codes which cannot be first object, or none\n"
+        << "set ancestors A1,A2,...     ancestors which cannot be first object, or none\n"
+        << "                            (muon, neutron, proton, pion, gamma, electron)\n"
+        << "reset                       selection of the event loop\n"
+        << "show                        current selection\n"
+        << "count                       cut flow of current selection\n"
+        << "hist deltaT|distance NBINS LOW HIGH [FILE]\n"
+        << "                            first object histograms, neutron and other,\n"
+        << "                            written to ROOT FILE if given\n"
+        << "quit                        end\n";
+}
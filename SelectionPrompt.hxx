@@ -0,0 +1,103 @@
+#ifndef SELECTIONPROMPT_HXX
+#define SELECTIONPROMPT_HXX
+
+#include "EventStore.hxx"
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief SelectionPrompt class
+ * @details SelectionPrompt reads commands from a prompt or a script
+ * file and answers them with EventStore::Select(), so cuts can be tuned
+ * on a loaded EventStore. \n
+ * Commands (one per line, '#' starts a comment):
+ * - set pions|antimuons|antimuonobjects N
+ * - set reject P1,P2,... (first object pdg codes, "none" for no code)
+ * - set ancestors A1,A2,... (muon, neutron, proton, pion, gamma, electron or none)
+ * - reset, show, count
+ * - hist deltaT|distance NBINS LOW HIGH [FILE]
+ * - help, quit
+ * @date 2026-10-17
+ */
+class SelectionPrompt
+{
+    public:
+        /**
+         * @brief initializer
+         * @param const EventStore& inStore: store to query, not owned
+         * @param int inNumberOfThreads: number of threads of each query,
+         * 0 means number of hardware threads
+         */
+        SelectionPrompt(const EventStore& inStore, int inNumberOfThreads);
+
+        /**
+         * @brief read and run commands until end of input or quit
+         * @param std::istream& in: commands
+         * @param std::ostream& out: answers
+         * @param bool inInteractive: write a prompt before each command
+         * @return bool false if a command failed
+         */
+        bool Run(std::istream& in, std::ostream& out, bool inInteractive);
+
+        /**
+         * @brief run one command
+         * @return bool false if command is not valid
+         */
+        bool RunCommand(const std::string& inCommand, std::ostream& out);
+
+        /**
+         * @brief get current selection
+         */
+        const EventStore::Selection& GetSelection() const;
+
+    private:
+        /**
+         * @brief run "set" command
+         */
+        bool Set(std::istream& inArguments, std::ostream& out);
+
+        /**
+         * @brief run "hist" command
+         */
+        bool Histogram(std::istream& inArguments, std::ostream& out);
+
+        /**
+         * @brief write current selection
+         */
+        void Show(std::ostream& out) const;
+
+        /**
+         * @brief write cut flow of result
+         */
+        void ShowCutFlow(const EventStore::Result& inResult, double inSeconds, std::ostream& out) const;
+
+        /**
+         * @brief write list of commands
+         */
+        static void Help(std::ostream& out);
+
+        /**
+         * @brief store to query
+         */
+        const EventStore& mStore;
+
+        /**
+         * @brief number of threads of each query
+         */
+        int mNumberOfThreads = 1;
+
+        /**
+         * @brief current selection
+         */
+        EventStore::Selection mSelection;
+
+        /**
+         * @brief quit command was read
+         */
+        bool mQuit = false;
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include "SkimIndex.hxx"
+
+#include <TEntryList.h>
+#include <TFile.h>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <sys/stat.h>
+
+const int SkimIndex::kSelectionVersion = 1;
+
+namespace
+{
+    const char* const kSkimMagic = "test_analysis-skim";
+}
+
+SkimIndex::SkimIndex(const std::string& inInputFileName)
+    : mInputFileName(inInputFileName)
+      ,mIndexFileName(inInputFileName + ".skim")
+{
+}
+
+const std::string& SkimIndex::GetIndexFileName() const
+{
+    return this->mIndexFileName;
+}
+
+std::string SkimIndex::GetInputKey() const
+{
+    return GetInputKey(this->mInputFileName);
+}
+
+std::string SkimIndex::GetInputKey(const std::string& inInputFileName)
+{
+    struct stat tempStat;
+    if (stat(inInputFileName.c_str(), &tempStat) != 0)
+    {
+        return "";
+    }
+    std::ostringstream tempKey;
+    tempKey << inInputFileName << " " << tempStat.st_size << " " << tempStat.st_mtime;
+    return tempKey.str();
+}
+
+bool SkimIndex::Load(Long64_t inNumberOfEntries)
+{
+    this->mEntries.clear();
+    const std::string tempInputKey = this->GetInputKey();
+    if (tempInputKey.empty())
+    {
+        return false;
+    }
+
+    std::ifstream tempFile(this->mIndexFileName);
+    if (!tempFile)
+    {
+        return false;
+    }
+
+    std::string tempMagic;
+    int tempVersion = -1;
+    Long64_t tempNumberOfEntries = -1;
+    std::size_t tempNumberOfSelected = 0;
+    std::string tempKey;
+    tempFile >> tempMagic >> tempVersion >> tempNumberOfEntries >> tempNumberOfSelected;
+    tempFile.ignore(1);
+    std::getline(tempFile, tempKey);
+    if (!tempFile
+            || tempMagic != kSkimMagic
+            || tempVersion != kSelectionVersion
+            || tempNumberOfEntries != inNumberOfEntries
+            || tempKey != tempInputKey)
+    {
+        return false;
+    }
+
+    std::vector<Long64_t> tempEntries;
+    tempEntries.reserve(tempNumberOfSelected);
+    Long64_t tempEntry;
+    while (tempFile >> tempEntry)
+    {
+        tempEntries.push_back(tempEntry);
+    }
+    if (tempEntries.size() != tempNumberOfSelected)
+    {
+        return false;
+    }
+    this->mEntries.swap(tempEntries);
+    return true;
+}
+
+bool SkimIndex::Save(Long64_t inNumberOfEntries) const
+{
+    const std::string tempInputKey = this->GetInputKey();
+    if (tempInputKey.empty())
+    {
+        return false;
+    }
+
+    // write to a temporary file first, so a crashed job never leaves a
+    // truncated index behind.
+    const std::string tempFileName = this->mIndexFileName + ".tmp";
+    {
+        std::ofstream tempFile(tempFileName);
+        if (!tempFile)
+        {
+            return false;
+        }
+        tempFile << kSkimMagic << " " << kSelectionVersion << " "
+            << inNumberOfEntries << " " << this->mEntries.size() << "\n";
+        tempFile << tempInputKey << "\n";
+        for (Long64_t tempEntry : this->mEntries)
+        {
+            tempFile << tempEntry << "\n";
+        }
+        if (!tempFile)
+        {
+            return false;
+        }
+    }
+    return std::rename(tempFileName.c_str(), this->mIndexFileName.c_str()) == 0;
+}
+
+void SkimIndex::SetEntries(std::vector<Long64_t> inEntries)
+{
+    this->mEntries = std::move(inEntries);
+}
+
+const std::vector<Long64_t>& SkimIndex::GetEntries() const
+{
+    return this->mEntries;
+}
+
+bool SkimIndex::WriteEvents(TChain& inChain, const std::vector<Long64_t>& inEntries,
+        const std::string& inOutputFileName)
+{
+    TEntryList tempEntryList;
+    for (Long64_t tempEntry : inEntries)
+    {
+        tempEntryList.Enter(tempEntry, &inChain);
+    }
+
+    std::unique_ptr<TFile> tempFile(TFile::Open(inOutputFileName.c_str(), "RECREATE"));
+    if (!tempFile || tempFile->IsZombie())
+    {
+        return false;
+    }
+    inChain.SetEntryList(&tempEntryList);
+    tempFile->cd();
+    TTree* tempSlimTree = inChain.CopyTree("");
+    inChain.SetEntryList(NULL);
+    if (!tempSlimTree)
+    {
+        return false;
+    }
+    tempSlimTree->Write();
+    tempFile->Close();
+    return true;
+}
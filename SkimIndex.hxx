@@ -0,0 +1,108 @@
+#ifndef SKIMINDEX_HXX
+#define SKIMINDEX_HXX
+
+#include <TChain.h>
+#include <Rtypes.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief SkimIndex class
+ * @details SkimIndex is a small sidecar file next to the input file
+ * ("<input>.skim") which has entry numbers of events surviving the
+ * CC0pi and single muon selection. Entries are local to the input
+ * file, so a chain of several files has one index per file. \n
+ * The index is keyed by input file (path, size, modification time,
+ * number of entries) and selection version, so a stale index is ignored.
+ * @date 2026-10-17
+ */
+class SkimIndex
+{
+    public:
+        /**
+         * @brief version of the skim selection
+         * @details increase this when the CC0pi or single muon selection
+         * in EventLoop::ProcessEvent changes.
+         */
+        static const int kSelectionVersion;
+
+        /**
+         * @brief initializer
+         * @param const std::string& inInputFileName: input file of the index
+         */
+        SkimIndex(const std::string& inInputFileName);
+
+        /**
+         * @brief get sidecar file name
+         * @return std::string "<input>.skim"
+         */
+        const std::string& GetIndexFileName() const;
+
+        /**
+         * @brief load index from sidecar file
+         * @param Long64_t inNumberOfEntries: number of entries in the input
+         * @return bool false if sidecar is missing, stale or of other
+         * selection version
+         */
+        bool Load(Long64_t inNumberOfEntries);
+
+        /**
+         * @brief save index to sidecar file
+         * @param Long64_t inNumberOfEntries: number of entries in the input
+         * @return bool false if sidecar cannot be written
+         */
+        bool Save(Long64_t inNumberOfEntries) const;
+
+        /**
+         * @brief set selected entries
+         * @param std::vector<Long64_t> inEntries: selected entries, ascending
+         */
+        void SetEntries(std::vector<Long64_t> inEntries);
+
+        /**
+         * @brief get selected entries
+         * @return const std::vector<Long64_t>&
+         */
+        const std::vector<Long64_t>& GetEntries() const;
+
+        /**
+         * @brief write selected events of inChain to slimmed output file
+         * @param TChain& inChain: input chain
+         * @param const std::vector<Long64_t>& inEntries: selected chain entries
+         * @param const std::string& inOutputFileName: output ROOT file name
+         * @return bool false if output file cannot be written
+         */
+        static bool WriteEvents(TChain& inChain, const std::vector<Long64_t>& inEntries,
+                const std::string& inOutputFileName);
+
+        /**
+         * @brief get key of input file
+         * @details "<path> <size> <modification time>", empty if input
+         * file does not exist. Other sidecar files use the same key.
+         */
+        static std::string GetInputKey(const std::string& inInputFileName);
+
+    private:
+        /**
+         * @brief get key of input file of this index
+         */
+        std::string GetInputKey() const;
+
+        /**
+         * @brief input file name
+         */
+        std::string mInputFileName;
+
+        /**
+         * @brief sidecar file name
+         */
+        std::string mIndexFileName;
+
+        /**
+         * @brief selected entries
+         */
+        std::vector<Long64_t> mEntries;
+};
+
+#endif
@@ -0,0 +1,315 @@
+#include "SpatialIndex.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+const int SpatialIndex::kObjectsPerCell = 2;
+const int SpatialIndex::kMaxCellsPerAxis = 64;
+
+void SpatialIndex::Clear()
+{
+    for (int a = 0; a < 3; ++a)
+    {
+        this->mOrigin[a] = 0;
+        this->mInverseCellSize[a] = 0;
+        this->mCellSize[a] = 0;
+        this->mNumberOfCells[a] = 0;
+    }
+    this->mCellStart.clear();
+    this->mX.clear();
+    this->mY.clear();
+    this->mZ.clear();
+    this->mKind.clear();
+    this->mRow.clear();
+    this->mObjectCell.clear();
+    this->mNext.clear();
+}
+
+void SpatialIndex::Build(const ObjectSnapshot& inSnapshot)
+{
+    this->Clear();
+    const std::size_t tempSize = inSnapshot.GetSize();
+    const double* tempPosition[3] = {inSnapshot.GetX().data(), inSnapshot.GetY().data(), inSnapshot.GetZ().data()};
+    const int* tempKind = inSnapshot.GetKind().data();
+
+    // bounding box of indexed objects
+    double tempLow[3];
+    double tempHigh[3];
+    std::fill(tempLow, tempLow + 3, std::numeric_limits<double>::infinity());
+    std::fill(tempHigh, tempHigh + 3, -std::numeric_limits<double>::infinity());
+    this->mObjectCell.assign(tempSize, -1);
+    int tempNumberOfObjects = 0;
+    for (std::size_t i = 0; i < tempSize; ++i)
+    {
+        if (tempKind[i] == ObjectSnapshot::kOther
+                || !std::isfinite(tempPosition[0][i])
+                || !std::isfinite(tempPosition[1][i])
+                || !std::isfinite(tempPosition[2][i]))
+        {
+            continue;
+        }
+        this->mObjectCell[i] = 0;
+        tempNumberOfObjects++;
+        for (int a = 0; a < 3; ++a)
+        {
+            tempLow[a] = std::min(tempLow[a], tempPosition[a][i]);
+            tempHigh[a] = std::max(tempHigh[a], tempPosition[a][i]);
+        }
+    }
+    if (tempNumberOfObjects == 0)
+    {
+        this->mCellStart.assign(1, 0);
+        return;
+    }
+
+    // cubic cells over the axes with extent, about kObjectsPerCell objects per cell
+    const double tempNumberOfCells = std::max(1.0, static_cast<double>(tempNumberOfObjects) / kObjectsPerCell);
+    double tempVolume = 1;
+    int tempDimension = 0;
+    for (int a = 0; a < 3; ++a)
+    {
+        if (tempHigh[a] > tempLow[a])
+        {
+            tempVolume *= tempHigh[a] - tempLow[a];
+            tempDimension++;
+        }
+    }
+    const double tempCellSize = tempDimension > 0 ? std::pow(tempVolume / tempNumberOfCells, 1.0 / tempDimension) : 0;
+    int tempTotalCells = 1;
+    for (int a = 0; a < 3; ++a)
+    {
+        const double tempExtent = tempHigh[a] - tempLow[a];
+        this->mOrigin[a] = tempLow[a];
+        this->mNumberOfCells[a] = tempExtent > 0 && tempCellSize > 0
+            ? static_cast<int>(std::min<double>(kMaxCellsPerAxis, std::max(1.0, std::ceil(tempExtent / tempCellSize))))
+            : 1;
+        this->mCellSize[a] = tempExtent > 0 ? tempExtent / this->mNumberOfCells[a] : 0;
+        this->mInverseCellSize[a] = tempExtent > 0 ? 1.0 / this->mCellSize[a] : 0;
+        tempTotalCells *= this->mNumberOfCells[a];
+    }
+
+    // counting sort of objects by cell
+    this->mCellStart.assign(tempTotalCells + 1, 0);
+    for (std::size_t i = 0; i < tempSize; ++i)
+    {
+        if (this->mObjectCell[i] < 0)
+        {
+            continue;
+        }
+        const int tempCell = (this->GetCell(2, tempPosition[2][i]) * this->mNumberOfCells[1]
+                + this->GetCell(1, tempPosition[1][i])) * this->mNumberOfCells[0]
+            + this->GetCell(0, tempPosition[0][i]);
+        this->mObjectCell[i] = tempCell;
+        this->mCellStart[tempCell + 1]++;
+    }
+    for (int c = 0; c < tempTotalCells; ++c)
+    {
+        this->mCellStart[c + 1] += this->mCellStart[c];
+    }
+    this->mX.resize(tempNumberOfObjects);
+    this->mY.resize(tempNumberOfObjects);
+    this->mZ.resize(tempNumberOfObjects);
+    this->mKind.resize(tempNumberOfObjects);
+    this->mRow.resize(tempNumberOfObjects);
+    this->mNext.assign(this->mCellStart.begin(), this->mCellStart.end() - 1);
+    for (std::size_t i = 0; i < tempSize; ++i)
+    {
+        const int tempCell = this->mObjectCell[i];
+        if (tempCell < 0)
+        {
+            continue;
+        }
+        const int tempIndex = this->mNext[tempCell]++;
+        this->mX[tempIndex] = tempPosition[0][i];
+        this->mY[tempIndex] = tempPosition[1][i];
+        this->mZ[tempIndex] = tempPosition[2][i];
+        this->mKind[tempIndex] = tempKind[i];
+        this->mRow[tempIndex] = static_cast<int>(i);
+    }
+}
+
+std::size_t SpatialIndex::GetSize() const
+{
+    return this->mRow.size();
+}
+
+int SpatialIndex::GetCell(int inAxis, double inValue) const
+{
+    const double tempCell = std::floor((inValue - this->mOrigin[inAxis]) * this->mInverseCellSize[inAxis]);
+    if (!(tempCell > 0))
+    {
+        return 0;
+    }
+    return static_cast<int>(std::min<double>(tempCell, this->mNumberOfCells[inAxis] - 1));
+}
+
+template <class Visitor>
+void SpatialIndex::VisitCells(const int inLow[3], const int inHigh[3], int inKind, Visitor inVisitor) const
+{
+    for (int z = inLow[2]; z <= inHigh[2]; ++z)
+    {
+        for (int y = inLow[1]; y <= inHigh[1]; ++y)
+        {
+            // cells along x are contiguous
+            const int tempRowCell = (z * this->mNumberOfCells[1] + y) * this->mNumberOfCells[0];
+            const int tempBegin = this->mCellStart[tempRowCell + inLow[0]];
+            const int tempEnd = this->mCellStart[tempRowCell + inHigh[0] + 1];
+            for (int i = tempBegin; i < tempEnd; ++i)
+            {
+                if (inKind < 0 || this->mKind[i] == inKind)
+                {
+                    inVisitor(i);
+                }
+            }
+        }
+    }
+}
+
+void SpatialIndex::FindInRadius(double inX, double inY, double inZ, double inRadius, int inKind,
+        std::vector<int>& outRows) const
+{
+    outRows.clear();
+    if (this->mRow.empty() || !(inRadius >= 0))
+    {
+        return;
+    }
+    const double tempPoint[3] = {inX, inY, inZ};
+    int tempLow[3];
+    int tempHigh[3];
+    for (int a = 0; a < 3; ++a)
+    {
+        tempLow[a] = this->GetCell(a, tempPoint[a] - inRadius);
+        tempHigh[a] = this->GetCell(a, tempPoint[a] + inRadius);
+    }
+    const double tempRadius2 = inRadius * inRadius;
+    this->VisitCells(tempLow, tempHigh, inKind, [&](int i)
+            {
+                const double tempDx = this->mX[i] - inX;
+                const double tempDy = this->mY[i] - inY;
+                const double tempDz = this->mZ[i] - inZ;
+                if (tempDx * tempDx + tempDy * tempDy + tempDz * tempDz <= tempRadius2)
+                {
+                    outRows.push_back(this->mRow[i]);
+                }
+            });
+    std::sort(outRows.begin(), outRows.end());
+}
+
+int SpatialIndex::CountInRadius(double inX, double inY, double inZ, double inRadius, int inKind) const
+{
+    if (this->mRow.empty() || !(inRadius >= 0))
+    {
+        return 0;
+    }
+    const double tempPoint[3] = {inX, inY, inZ};
+    int tempLow[3];
+    int tempHigh[3];
+    for (int a = 0; a < 3; ++a)
+    {
+        tempLow[a] = this->GetCell(a, tempPoint[a] - inRadius);
+        tempHigh[a] = this->GetCell(a, tempPoint[a] + inRadius);
+    }
+    const double tempRadius2 = inRadius * inRadius;
+    int tempCount = 0;
+    this->VisitCells(tempLow, tempHigh, inKind, [&](int i)
+            {
+                const double tempDx = this->mX[i] - inX;
+                const double tempDy = this->mY[i] - inY;
+                const double tempDz = this->mZ[i] - inZ;
+                tempCount += (tempDx * tempDx + tempDy * tempDy + tempDz * tempDz <= tempRadius2);
+            });
+    return tempCount;
+}
+
+int SpatialIndex::FindNearest(double inX, double inY, double inZ, int inKind, int inExcludedRow,
+        double* outDistance) const
+{
+    int tempBestRow = -1;
+    double tempBestDistance2 = std::numeric_limits<double>::infinity();
+    if (!this->mRow.empty())
+    {
+        const double tempPoint[3] = {inX, inY, inZ};
+        int tempCenter[3];
+        int tempMaxRing = 0;
+        for (int a = 0; a < 3; ++a)
+        {
+            tempCenter[a] = this->GetCell(a, tempPoint[a]);
+            tempMaxRing = std::max(tempMaxRing, std::max(tempCenter[a], this->mNumberOfCells[a] - 1 - tempCenter[a]));
+        }
+
+        // rings of cells around the cell of the point, until no closer object can be outside
+        for (int r = 0; r <= tempMaxRing; ++r)
+        {
+            int tempLow[3];
+            int tempHigh[3];
+            double tempBound = std::numeric_limits<double>::infinity();
+            for (int a = 0; a < 3; ++a)
+            {
+                tempLow[a] = std::max(0, tempCenter[a] - r);
+                tempHigh[a] = std::min(this->mNumberOfCells[a] - 1, tempCenter[a] + r);
+                // objects outside the cube are beyond one of its inner faces
+                if (tempLow[a] > 0)
+                {
+                    tempBound = std::min(tempBound, tempPoint[a] - (this->mOrigin[a] + tempLow[a] * this->mCellSize[a]));
+                }
+                if (tempHigh[a] < this->mNumberOfCells[a] - 1)
+                {
+                    tempBound = std::min(tempBound, this->mOrigin[a] + (tempHigh[a] + 1) * this->mCellSize[a] - tempPoint[a]);
+                }
+            }
+            auto tempVisitor = [&](int i)
+            {
+                const double tempDx = this->mX[i] - inX;
+                const double tempDy = this->mY[i] - inY;
+                const double tempDz = this->mZ[i] - inZ;
+                const double tempDistance2 = tempDx * tempDx + tempDy * tempDy + tempDz * tempDz;
+                const int tempRow = this->mRow[i];
+                if (tempRow != inExcludedRow
+                        && (tempDistance2 < tempBestDistance2
+                            || (tempDistance2 == tempBestDistance2 && tempRow < tempBestRow)))
+                {
+                    tempBestDistance2 = tempDistance2;
+                    tempBestRow = tempRow;
+                }
+            };
+            // only the shell of the cube, inner cells are visited by the previous rings
+            int tempInnerLow[3];
+            int tempInnerHigh[3];
+            std::copy(tempLow, tempLow + 3, tempInnerLow);
+            std::copy(tempHigh, tempHigh + 3, tempInnerHigh);
+            for (int a = 2; a >= 0 && r > 0; --a)
+            {
+                int tempFaceLow[3];
+                int tempFaceHigh[3];
+                std::copy(tempInnerLow, tempInnerLow + 3, tempFaceLow);
+                std::copy(tempInnerHigh, tempInnerHigh + 3, tempFaceHigh);
+                if (tempCenter[a] - r >= 0)
+                {
+                    tempFaceLow[a] = tempFaceHigh[a] = tempCenter[a] - r;
+                    this->VisitCells(tempFaceLow, tempFaceHigh, inKind, tempVisitor);
+                }
+                if (tempCenter[a] + r < this->mNumberOfCells[a])
+                {
+                    tempFaceLow[a] = tempFaceHigh[a] = tempCenter[a] + r;
+                    this->VisitCells(tempFaceLow, tempFaceHigh, inKind, tempVisitor);
+                }
+                tempInnerLow[a] = std::max(0, tempCenter[a] - r + 1);
+                tempInnerHigh[a] = std::min(this->mNumberOfCells[a] - 1, tempCenter[a] + r - 1);
+            }
+            if (r == 0)
+            {
+                this->VisitCells(tempLow, tempHigh, inKind, tempVisitor);
+            }
+            if (tempBestRow >= 0 && tempBound > 0 && tempBestDistance2 < tempBound * tempBound)
+            {
+                break;
+            }
+        }
+    }
+    if (outDistance)
+    {
+        *outDistance = std::sqrt(tempBestDistance2);
+    }
+    return tempBestRow;
+}
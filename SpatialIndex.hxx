@@ -0,0 +1,139 @@
+#ifndef SPATIALINDEX_HXX
+#define SPATIALINDEX_HXX
+
+#include "ObjectSnapshot.hxx"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief SpatialIndex class
+ * @details SpatialIndex is a uniform grid over positions of the tracks
+ * and clusters of an ObjectSnapshot. \n
+ * The grid covers the bounding box of the objects with about
+ * kObjectsPerCell objects per cell. Objects are counting sorted by cell
+ * and their positions copied in cell order, so building is linear in
+ * the number of objects and a query reads only the cells it overlaps. \n
+ * Rows returned by queries are rows of the snapshot.
+ * @date 2026-10-17
+ */
+class SpatialIndex
+{
+    public:
+        /**
+         * @brief average number of objects per cell
+         */
+        static const int kObjectsPerCell;
+
+        /**
+         * @brief maximum number of cells per axis
+         */
+        static const int kMaxCellsPerAxis;
+
+        /**
+         * @brief remove all objects
+         * @details memory is kept for the next event.
+         */
+        void Clear();
+
+        /**
+         * @brief build index of tracks and clusters of snapshot
+         * @details objects which are neither track nor cluster, or have
+         * no finite position, are not indexed.
+         */
+        void Build(const ObjectSnapshot& inSnapshot);
+
+        /**
+         * @brief get number of indexed objects
+         */
+        std::size_t GetSize() const;
+
+        /**
+         * @brief find objects within radius of point
+         * @param double inX, inY, inZ: point
+         * @param double inRadius: radius, objects at inRadius are included
+         * @param int inKind: ObjectSnapshot::Kind of objects, -1 means any
+         * @param std::vector<int>& outRows: snapshot rows, ascending
+         */
+        void FindInRadius(double inX, double inY, double inZ, double inRadius, int inKind,
+                std::vector<int>& outRows) const;
+
+        /**
+         * @brief count objects within radius of point
+         * @details same as FindInRadius() without output rows.
+         */
+        int CountInRadius(double inX, double inY, double inZ, double inRadius, int inKind) const;
+
+        /**
+         * @brief find nearest object to point
+         * @details ties are broken by the lowest row.
+         * @param double inX, inY, inZ: point
+         * @param int inKind: ObjectSnapshot::Kind of objects, -1 means any
+         * @param int inExcludedRow: row which is not returned (e.g. the
+         * object at the point), -1 means none
+         * @param double* outDistance: distance to the nearest object, may be NULL
+         * @return int snapshot row, -1 if there is no such object
+         */
+        int FindNearest(double inX, double inY, double inZ, int inKind, int inExcludedRow,
+                double* outDistance = NULL) const;
+
+    private:
+        /**
+         * @brief get cell index along axis, clamped to the grid
+         */
+        int GetCell(int inAxis, double inValue) const;
+
+        /**
+         * @brief visit objects of cells [inLow, inHigh] of every axis
+         * @details inVisitor(position in cell order) is called for every
+         * object of inKind in these cells.
+         */
+        template <class Visitor>
+        void VisitCells(const int inLow[3], const int inHigh[3], int inKind, Visitor inVisitor) const;
+
+        /**
+         * @brief lower corner of the grid
+         */
+        double mOrigin[3] = {0, 0, 0};
+
+        /**
+         * @brief inverse of cell size of each axis
+         */
+        double mInverseCellSize[3] = {0, 0, 0};
+
+        /**
+         * @brief cell size of each axis
+         */
+        double mCellSize[3] = {0, 0, 0};
+
+        /**
+         * @brief number of cells of each axis
+         */
+        int mNumberOfCells[3] = {0, 0, 0};
+
+        /**
+         * @brief first object of each cell in cell order, one more than cells
+         */
+        std::vector<int> mCellStart;
+
+        /**
+         * @brief objects in cell order
+         */
+        std::vector<double> mX;
+        std::vector<double> mY;
+        std::vector<double> mZ;
+        std::vector<int> mKind;
+        std::vector<int> mRow;
+
+        /**
+         * @brief cell of each indexed object in snapshot order, used while building
+         */
+        std::vector<int> mObjectCell;
+
+        /**
+         * @brief next free position of each cell, used while building
+         */
+        std::vector<int> mNext;
+};
+
+#endif
@@ -0,0 +1,18 @@
+#include "StringUtility.hxx"
+
+#include <sstream>
+
+std::vector<std::string> SplitList(const std::string& inList)
+{
+    std::vector<std::string> tempItems;
+    std::stringstream tempList(inList);
+    std::string tempItem;
+    while (std::getline(tempList, tempItem, ','))
+    {
+        if (!tempItem.empty())
+        {
+            tempItems.push_back(tempItem);
+        }
+    }
+    return tempItems;
+}
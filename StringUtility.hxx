@@ -0,0 +1,15 @@
+#ifndef STRINGUTILITY_HXX
+#define STRINGUTILITY_HXX
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief split comma separated list, empty items are skipped
+ * @details used for command line lists and SelectionPrompt commands.
+ * @param const std::string& inList: e.g. "a,b,,c"
+ * @return std::vector<std::string> items, e.g. {"a", "b", "c"}
+ */
+std::vector<std::string> SplitList(const std::string& inList);
+
+#endif
@@ -0,0 +1,205 @@
+#include "SummaryWriter.hxx"
+
+#include <TBranch.h>
+#include <TObjArray.h>
+
+#include <cmath>
+
+SummaryWriter::SummaryWriter(const std::string& inFileName)
+    : mFile(TFile::Open(inFileName.c_str(), "RECREATE"))
+{
+    if (!this->mFile || this->mFile->IsZombie())
+    {
+        this->mFile.reset();
+        return;
+    }
+    this->mFile->cd();
+    this->mTree = new TTree("AnalysisSummary", "summary of selected events");
+    this->mTree->Branch("entry", &this->mRow.entry, "entry/L");
+    this->mTree->Branch("vertexX", &this->mRow.vertexX, "vertexX/D");
+    this->mTree->Branch("vertexY", &this->mRow.vertexY, "vertexY/D");
+    this->mTree->Branch("vertexZ", &this->mRow.vertexZ, "vertexZ/D");
+    this->mTree->Branch("vertexT", &this->mRow.vertexT, "vertexT/D");
+    this->mTree->Branch("firstKind", &this->mRow.firstKind, "firstKind/I");
+    this->mTree->Branch("firstX", &this->mRow.firstX, "firstX/D");
+    this->mTree->Branch("firstY", &this->mRow.firstY, "firstY/D");
+    this->mTree->Branch("firstZ", &this->mRow.firstZ, "firstZ/D");
+    this->mTree->Branch("firstT", &this->mRow.firstT, "firstT/D");
+    this->mTree->Branch("firstPdg", &this->mRow.firstPdg, "firstPdg/I");
+    this->mTree->Branch("firstParentId", &this->mRow.firstParentId, "firstParentId/I");
+    this->mTree->Branch("firstParentPdg", &this->mRow.firstParentPdg, "firstParentPdg/I");
+    this->mTree->Branch("firstPrimaryId", &this->mRow.firstPrimaryId, "firstPrimaryId/I");
+    this->mTree->Branch("firstAncestorFlags", &this->mRow.firstAncestorFlags, "firstAncestorFlags/i");
+    this->mTree->Branch("firstIsolation", &this->mRow.firstIsolation, "firstIsolation/D");
+    this->mTree->Branch("numberOfTracks", &this->mRow.numberOfTracks, "numberOfTracks/I");
+    this->mTree->Branch("numberOfClusters", &this->mRow.numberOfClusters, "numberOfClusters/I");
+}
+
+SummaryWriter::~SummaryWriter()
+{
+    this->Close();
+}
+
+bool SummaryWriter::IsOpen() const
+{
+    return this->mFile != nullptr;
+}
+
+void SummaryWriter::Write(std::vector<EventSummary>& inBatch)
+{
+    std::lock_guard<std::mutex> tempLock(this->mMutex);
+    if (this->mTree)
+    {
+        for (const EventSummary& tempSummary : inBatch)
+        {
+            this->mRow = tempSummary;
+            this->mTree->Fill();
+        }
+    }
+    inBatch.clear();
+}
+
+void SummaryWriter::Close()
+{
+    std::lock_guard<std::mutex> tempLock(this->mMutex);
+    if (!this->mFile)
+    {
+        return;
+    }
+    this->mFile->cd();
+    this->mTree->Write();
+    this->mFile->Close();
+    this->mFile.reset();
+    this->mTree = NULL;
+}
+
+bool SummaryWriter::CopyRows(const std::string& inFileName, Long64_t inNumberOfRows)
+{
+    std::unique_ptr<TFile> tempFile(TFile::Open(inFileName.c_str(), "READ"));
+    if (!tempFile || tempFile->IsZombie())
+    {
+        return inNumberOfRows == 0;
+    }
+    TTree* tempTree = static_cast<TTree*>(tempFile->Get("AnalysisSummary"));
+    if (!tempTree || tempTree->GetEntries() < inNumberOfRows || !this->mTree)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> tempLock(this->mMutex);
+    // read into the branch buffer of the output tree
+    TObjArray* tempBranches = this->mTree->GetListOfBranches();
+    for (int i = 0; i < tempBranches->GetEntries(); ++i)
+    {
+        TBranch* tempBranch = static_cast<TBranch*>(tempBranches->At(i));
+        tempTree->SetBranchAddress(tempBranch->GetName(), tempBranch->GetAddress());
+    }
+    for (Long64_t i = 0; i < inNumberOfRows; ++i)
+    {
+        tempTree->GetEntry(i);
+        this->mTree->Fill();
+    }
+    tempTree->ResetBranchAddresses();
+    return true;
+}
+
+void SummaryWriter::AutoSave()
+{
+    std::lock_guard<std::mutex> tempLock(this->mMutex);
+    if (this->mTree)
+    {
+        this->mTree->AutoSave("SaveSelf");
+    }
+}
+
+Long64_t SummaryWriter::GetNumberOfRows()
+{
+    std::lock_guard<std::mutex> tempLock(this->mMutex);
+    return this->mTree ? this->mTree->GetEntries() : 0;
+}
+
+void SummaryWriter::WriteObject(const TObject& inObject, const char* inName)
+{
+    std::lock_guard<std::mutex> tempLock(this->mMutex);
+    if (this->mFile)
+    {
+        this->mFile->WriteTObject(&inObject, inName, "Overwrite");
+    }
+}
+
+void SummaryWriter::WriteShardInfo(Long64_t inFirst, Long64_t inLast, Int_t inShard, Int_t inNumberOfShards)
+{
+    std::lock_guard<std::mutex> tempLock(this->mMutex);
+    if (!this->mFile)
+    {
+        return;
+    }
+    this->mFile->cd();
+    TTree tempShardInfo("ShardInfo", "entry range of this output");
+    tempShardInfo.Branch("first", &inFirst, "first/L");
+    tempShardInfo.Branch("last", &inLast, "last/L");
+    tempShardInfo.Branch("shard", &inShard, "shard/I");
+    tempShardInfo.Branch("numberOfShards", &inNumberOfShards, "numberOfShards/I");
+    tempShardInfo.Fill();
+    tempShardInfo.Write("", TObject::kOverwrite);
+    tempShardInfo.SetDirectory(NULL);
+}
+
+EventSummary SummaryWriter::MakeSummary(const EventAnalysis& inEventAnalysis, Long64_t inEntry)
+{
+    EventSummary tempSummary;
+    tempSummary.entry = inEntry;
+
+    const TLorentzVector& vertex = inEventAnalysis.GetVertex();
+    tempSummary.vertexX = vertex.X();
+    tempSummary.vertexY = vertex.Y();
+    tempSummary.vertexZ = vertex.Z();
+    tempSummary.vertexT = vertex.T();
+
+    const ObjectSnapshot& tempSnapshot = inEventAnalysis.GetSnapshot();
+    const int tempFirst = inEventAnalysis.GetFirstObjectIndex();
+    if (tempFirst >= 0 && tempSnapshot.GetKind()[tempFirst] != ObjectSnapshot::kOther)
+    {
+        const TLorentzVector tempPosition = tempSnapshot.GetPosition(tempFirst);
+        tempSummary.firstKind = tempSnapshot.GetKind()[tempFirst];
+        tempSummary.firstX = tempPosition.X();
+        tempSummary.firstY = tempPosition.Y();
+        tempSummary.firstZ = tempPosition.Z();
+        tempSummary.firstT = tempPosition.T();
+        tempSummary.firstPdg = tempSnapshot.GetPdg()[tempFirst];
+        tempSummary.firstParentId = tempSnapshot.GetParentId()[tempFirst];
+        tempSummary.firstParentPdg = tempSnapshot.GetParentPdg()[tempFirst];
+        tempSummary.firstPrimaryId = tempSnapshot.GetPrimaryId()[tempFirst];
+        tempSummary.firstAncestorFlags = tempSnapshot.GetAncestorFlags()[tempFirst];
+        const double tempIsolation = inEventAnalysis.GetFirstObjectIsolation();
+        tempSummary.firstIsolation = std::isfinite(tempIsolation) ? tempIsolation : -1;
+    }
+
+    tempSummary.numberOfTracks = inEventAnalysis.GetTrackVector().size();
+    tempSummary.numberOfClusters = inEventAnalysis.GetClusterVector().size();
+    return tempSummary;
+}
+
+SummaryBuffer::SummaryBuffer(SummaryWriter* inWriter, size_t inBatchSize)
+    : mWriter(inWriter)
+      ,mBatchSize(inBatchSize)
+{
+    this->mBatch.reserve(inBatchSize);
+}
+
+void SummaryBuffer::Fill(const EventSummary& inSummary)
+{
+    this->mBatch.push_back(inSummary);
+    if (this->mBatchSize != 0 && this->mBatch.size() >= this->mBatchSize)
+    {
+        this->Flush();
+    }
+}
+
+void SummaryBuffer::Flush()
+{
+    if (this->mWriter && !this->mBatch.empty())
+    {
+        this->mWriter->Write(this->mBatch);
+    }
+}
@@ -0,0 +1,196 @@
+#ifndef SUMMARYWRITER_HXX
+#define SUMMARYWRITER_HXX
+
+#include "EventAnalysis.hxx"
+
+#include <TFile.h>
+#include <TTree.h>
+#include <Rtypes.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief summary of one selected event
+ * @details one row of the analysis ntuple, every column has fixed width.
+ */
+struct EventSummary
+{
+    Long64_t entry = -1;
+    Double_t vertexX = 0;
+    Double_t vertexY = 0;
+    Double_t vertexZ = 0;
+    Double_t vertexT = 0;
+    Int_t firstKind = 0; //0: no first object, 1: track, 2: cluster
+    Double_t firstX = 0;
+    Double_t firstY = 0;
+    Double_t firstZ = 0;
+    Double_t firstT = 0;
+    Int_t firstPdg = 0;
+    Int_t firstParentId = 0;
+    Int_t firstParentPdg = 0;
+    Int_t firstPrimaryId = 0;
+    UInt_t firstAncestorFlags = 0; //TruthIndex::AncestorFlag
+    Double_t firstIsolation = -1; //distance to the nearest other track, -1: no other track
+    Int_t numberOfTracks = 0;
+    Int_t numberOfClusters = 0;
+};
+
+/**
+ * @brief SummaryWriter class
+ * @details SummaryWriter writes EventSummary to a flat TTree
+ * "AnalysisSummary", one branch per column, so downstream jobs can
+ * read only the columns they need. \n
+ * Rows are filled in batches from SummaryBuffer, one buffer per thread.
+ * @date 2026-10-17
+ */
+class SummaryWriter
+{
+    public:
+        /**
+         * @brief initializer
+         * @details check IsOpen(), nothing is written if the file cannot
+         * be opened.
+         * @param const std::string& inFileName: output ROOT file name
+         */
+        SummaryWriter(const std::string& inFileName);
+
+        /**
+         * @brief check if output file is open
+         * @return bool false if the file cannot be opened or is closed
+         */
+        bool IsOpen() const;
+
+        /**
+         * @brief write the tree and close the output file
+         */
+        ~SummaryWriter();
+
+        /**
+         * @brief fill rows of inBatch to the tree and clear inBatch
+         * @details thread safe.
+         */
+        void Write(std::vector<EventSummary>& inBatch);
+
+        /**
+         * @brief write the tree and close the output file
+         */
+        void Close();
+
+        /**
+         * @brief copy first rows of the summary tree of another file
+         * @details used to resume a run from a checkpoint.
+         * @param const std::string& inFileName: file written by SummaryWriter
+         * @param Long64_t inNumberOfRows: number of rows to copy
+         * @return bool false if file has less than inNumberOfRows rows
+         */
+        bool CopyRows(const std::string& inFileName, Long64_t inNumberOfRows);
+
+        /**
+         * @brief save the tree header, so rows filled so far can be read
+         * back if the job is killed
+         * @details thread safe.
+         */
+        void AutoSave();
+
+        /**
+         * @brief get number of rows filled to the tree
+         * @details thread safe.
+         */
+        Long64_t GetNumberOfRows();
+
+        /**
+         * @brief write object to the output file
+         * @details thread safe.
+         * @param const TObject& inObject: object to write (e.g. histogram)
+         * @param const char* inName: key name in the file
+         */
+        void WriteObject(const TObject& inObject, const char* inName);
+
+        /**
+         * @brief write entry range of this output to "ShardInfo" tree
+         * @details the merge command orders outputs by first entry.
+         * @param Long64_t inFirst: first entry
+         * @param Long64_t inLast: last entry, not included
+         * @param Int_t inShard: shard index
+         * @param Int_t inNumberOfShards: number of shards
+         */
+        void WriteShardInfo(Long64_t inFirst, Long64_t inLast, Int_t inShard, Int_t inNumberOfShards);
+
+        /**
+         * @brief make summary of analyzed event
+         * @details vertex and first object should be already set.
+         * @param const EventAnalysis& inEventAnalysis: analyzed event
+         * @param Long64_t inEntry: entry number of event
+         */
+        static EventSummary MakeSummary(const EventAnalysis& inEventAnalysis, Long64_t inEntry);
+
+    private:
+        /**
+         * @brief output file
+         */
+        std::unique_ptr<TFile> mFile;
+
+        /**
+         * @brief output tree, owned by mFile
+         */
+        TTree* mTree = NULL;
+
+        /**
+         * @brief branch buffer of the tree
+         */
+        EventSummary mRow;
+
+        /**
+         * @brief lock of mTree
+         */
+        std::mutex mMutex;
+};
+
+/**
+ * @brief SummaryBuffer class
+ * @details per thread buffer of SummaryWriter. \n
+ * Summaries are written to the writer when the batch is full,
+ * or when Flush() is called.
+ */
+class SummaryBuffer
+{
+    public:
+        /**
+         * @brief initializer
+         * @param SummaryWriter* inWriter: writer, not owned
+         * @param size_t inBatchSize: number of rows per batch,
+         * 0 means rows are kept until Flush()
+         */
+        SummaryBuffer(SummaryWriter* inWriter, size_t inBatchSize = 1024);
+
+        /**
+         * @brief add summary to the batch
+         */
+        void Fill(const EventSummary& inSummary);
+
+        /**
+         * @brief write all buffered summaries to the writer
+         */
+        void Flush();
+
+    private:
+        /**
+         * @brief writer of this buffer
+         */
+        SummaryWriter* mWriter = NULL;
+
+        /**
+         * @brief number of rows per batch
+         */
+        size_t mBatchSize = 0;
+
+        /**
+         * @brief buffered summaries
+         */
+        std::vector<EventSummary> mBatch;
+};
+
+#endif
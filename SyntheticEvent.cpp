@@ -0,0 +1,89 @@
+#include "SyntheticEvent.hxx"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+    /**
+     * @brief add trajectory to event
+     */
+    void AddTrajectory(Cube::Event& inEvent, int inTrackId, int inParentId, int inPDGCode)
+    {
+        Cube::Handle<Cube::G4Trajectory> tempTrajectory(new Cube::G4Trajectory);
+        tempTrajectory->SetTrackId(inTrackId);
+        tempTrajectory->SetParentId(inParentId);
+        tempTrajectory->SetPDGCode(inPDGCode);
+        inEvent.G4Trajectories[inTrackId] = tempTrajectory;
+    }
+}
+
+SyntheticEvent::SyntheticEvent(const Config& inConfig)
+    : mEvent(std::make_unique<Cube::Event> ())
+{
+    std::mt19937 tempRandom(inConfig.seed);
+    std::uniform_real_distribution<double> tempPosition(-1000.0, 1000.0);
+    std::uniform_real_distribution<double> tempTime(0.0, 100.0);
+    std::uniform_real_distribution<double> tempUniform(0.0, 1.0);
+
+    // trajectory 1 is the primary anti muon, the others are primary
+    // nucleons or secondaries of an earlier trajectory.
+    const int tempNumberOfTrajectories = std::max(2, inConfig.numberOfTrajectories);
+    const int tempPrimaryPdg[] = {2212, 2112};
+    const int tempSecondaryPdg[] = {2212, 2112, 22, 11, -11};
+    AddTrajectory(*this->mEvent, 1, -1, -13);
+    for (int id = 2; id <= tempNumberOfTrajectories; ++id)
+    {
+        if (tempUniform(tempRandom) < 0.3)
+        {
+            AddTrajectory(*this->mEvent, id, -1, tempPrimaryPdg[tempRandom() % 2]);
+        }
+        else
+        {
+            const int tempParentId = 1 + tempRandom() % (id - 1);
+            AddTrajectory(*this->mEvent, id, tempParentId, tempSecondaryPdg[tempRandom() % 5]);
+        }
+    }
+
+    Cube::Handle<Cube::ReconObjectContainer> tempObjects(new Cube::ReconObjectContainer("final"));
+    const int tempNumberOfObjects = std::max(1, inConfig.numberOfTracks) + inConfig.numberOfClusters;
+    tempObjects->reserve(tempNumberOfObjects);
+    this->mMainTrajectories.reserve(tempNumberOfObjects);
+
+    // first track is the anti muon track, it makes the vertex.
+    Cube::Handle<Cube::ReconTrack> tempMuonTrack(new Cube::ReconTrack);
+    tempMuonTrack->GetState()->SetPosition(tempPosition(tempRandom), tempPosition(tempRandom),
+            tempPosition(tempRandom), tempTime(tempRandom));
+    tempObjects->push_back(tempMuonTrack);
+    this->mMainTrajectories.push_back(1);
+
+    for (int i = 1; i < inConfig.numberOfTracks; ++i)
+    {
+        Cube::Handle<Cube::ReconTrack> tempTrack(new Cube::ReconTrack);
+        tempTrack->GetState()->SetPosition(tempPosition(tempRandom), tempPosition(tempRandom),
+                tempPosition(tempRandom), tempTime(tempRandom));
+        tempObjects->push_back(tempTrack);
+        this->mMainTrajectories.push_back(2 + tempRandom() % (tempNumberOfTrajectories - 1));
+    }
+
+    for (int i = 0; i < inConfig.numberOfClusters; ++i)
+    {
+        Cube::Handle<Cube::ReconCluster> tempCluster(new Cube::ReconCluster);
+        tempCluster->GetState()->SetPosition(tempPosition(tempRandom), tempPosition(tempRandom),
+                tempPosition(tempRandom), tempTime(tempRandom));
+        tempObjects->push_back(tempCluster);
+        this->mMainTrajectories.push_back(2 + tempRandom() % (tempNumberOfTrajectories - 1));
+    }
+
+    this->mEvent->AddObjectContainer(tempObjects);
+}
+
+Cube::Event* SyntheticEvent::GetEvent() const
+{
+    return this->mEvent.get();
+}
+
+const std::vector<int>& SyntheticEvent::GetMainTrajectories() const
+{
+    return this->mMainTrajectories;
+}
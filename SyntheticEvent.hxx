@@ -0,0 +1,68 @@
+#ifndef SYNTHETICEVENT_HXX
+#define SYNTHETICEVENT_HXX
+
+#include <CubeEvent.hxx>
+#include <CubeReconObject.hxx>
+#include <CubeReconCluster.hxx>
+#include <CubeReconTrack.hxx>
+#include <CubeHandle.hxx>
+#include <CubeG4Trajectory.hxx>
+
+#include <memory>
+#include <vector>
+
+/**
+ * @brief SyntheticEvent class
+ * @details SyntheticEvent builds a Cube::Event without input file. \n
+ * G4Trajectories has one primary anti muon and configurable number of
+ * secondary trajectories, the "final" ReconObjectContainer has
+ * configurable number of tracks and clusters with random position and time. \n
+ * Objects have no hits, so main trajectory of each object is given by
+ * GetMainTrajectories() instead of Cube::Tool::MainTrajectory.
+ * @date 2026-10-17
+ */
+class SyntheticEvent
+{
+    public:
+        /**
+         * @brief multiplicity of synthetic event
+         */
+        struct Config
+        {
+            int numberOfTracks = 10;
+            int numberOfClusters = 20;
+            int numberOfTrajectories = 50;
+            unsigned int seed = 1;
+        };
+
+        /**
+         * @brief initializer
+         * @param const Config& inConfig: multiplicity and random seed
+         */
+        SyntheticEvent(const Config& inConfig);
+
+        /**
+         * @brief get event
+         * @return Cube::Event*, owned by this object
+         */
+        Cube::Event* GetEvent() const;
+
+        /**
+         * @brief get main trajectory id of each object
+         * @return const std::vector<int>&, in order of "final" container
+         */
+        const std::vector<int>& GetMainTrajectories() const;
+
+    private:
+        /**
+         * @brief event
+         */
+        std::unique_ptr<Cube::Event> mEvent;
+
+        /**
+         * @brief main trajectory id of each object
+         */
+        std::vector<int> mMainTrajectories;
+};
+
+#endif
@@ -0,0 +1,258 @@
+#include "TruthIndex.hxx"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <limits>
+
+const int TruthIndex::kNoTrajectory = std::numeric_limits<int>::min();
+
+void TruthIndex::Build(Cube::Event* inEvent)
+{
+    this->Clear();
+    this->mEvent = inEvent;
+    this->mTrajectoryIds.reserve(inEvent->G4Trajectories.size());
+    this->mTrajectories.reserve(inEvent->G4Trajectories.size());
+    for (Cube::Event::G4TrajectoryContainer::iterator g4Trajectory
+            = inEvent->G4Trajectories.begin();
+            g4Trajectory != inEvent->G4Trajectories.end();
+            ++g4Trajectory)
+    {
+        const Cube::Handle<Cube::G4Trajectory>& gt = g4Trajectory->second; //trajectory
+        TrajectoryInfo tempInfo;
+        tempInfo.pdg = gt->GetPDGCode();
+        tempInfo.parentId = gt->GetParentId();
+        this->mTrajectoryIds.push_back(g4Trajectory->first);
+        this->mTrajectories.push_back(tempInfo);
+    }
+    this->mContiguousIds = this->mTrajectoryIds.empty()
+        || (static_cast<long>(this->mTrajectoryIds.back()) - this->mTrajectoryIds.front() + 1
+                == static_cast<long>(this->mTrajectoryIds.size()));
+    this->ResolveAncestry();
+}
+
+void TruthIndex::ResolveAncestry()
+{
+    const int kUnresolved = -1;
+    for (TrajectoryInfo& tempInfo : this->mTrajectories)
+    {
+        tempInfo.depth = kUnresolved;
+    }
+
+    for (std::size_t i = 0; i < this->mTrajectories.size(); ++i)
+    {
+        if (this->mTrajectories[i].depth != kUnresolved)
+        {
+            continue;
+        }
+
+        // walk up until a resolved trajectory or a primary
+        this->mAncestryPath.clear();
+        int tempIndex = static_cast<int>(i);
+        int tempTop = -1;
+        while (tempIndex >= 0 && this->mTrajectories[tempIndex].depth == kUnresolved)
+        {
+            this->mAncestryPath.push_back(tempIndex);
+            if (this->mAncestryPath.size() > this->mTrajectories.size())
+            {
+                // parent loop, should not happen in G4Trajectories
+                break;
+            }
+            tempIndex = this->FindTrajectoryIndex(this->mTrajectories[tempIndex].parentId);
+        }
+        if (tempIndex >= 0 && this->mTrajectories[tempIndex].depth != kUnresolved)
+        {
+            tempTop = tempIndex;
+        }
+
+        // fill from the top of the path
+        for (std::vector<int>::reverse_iterator p = this->mAncestryPath.rbegin();
+                p != this->mAncestryPath.rend(); ++p)
+        {
+            TrajectoryInfo& tempInfo = this->mTrajectories[*p];
+            if (tempTop < 0)
+            {
+                tempInfo.primaryId = this->mTrajectoryIds[*p];
+                tempInfo.depth = 0;
+                tempInfo.ancestorFlags = 0;
+            }
+            else
+            {
+                const TrajectoryInfo& tempParent = this->mTrajectories[tempTop];
+                tempInfo.primaryId = tempParent.primaryId;
+                tempInfo.depth = tempParent.depth + 1;
+                tempInfo.ancestorFlags = tempParent.ancestorFlags | GetPdgFlag(tempParent.pdg);
+            }
+            tempTop = *p;
+        }
+    }
+}
+
+unsigned int TruthIndex::GetPdgFlag(int inPdg)
+{
+    switch (std::abs(inPdg))
+    {
+        case 13: return kMuonAncestor;
+        case 2112: return kNeutronAncestor;
+        case 2212: return kProtonAncestor;
+        case 211: return kPionAncestor;
+        case 111: return kPionAncestor;
+        case 22: return kGammaAncestor;
+        case 11: return kElectronAncestor;
+        default: return 0;
+    }
+}
+
+void TruthIndex::Clear()
+{
+    this->mEvent = NULL;
+    this->mTrajectoryIds.clear();
+    this->mTrajectories.clear();
+    this->mContiguousIds = true;
+    for (std::size_t tempSlot : this->mUsedSlots)
+    {
+        this->mMatches[tempSlot] = MatchSlot();
+    }
+    this->mUsedSlots.clear();
+}
+
+int TruthIndex::FindTrajectoryIndex(int inTrajectoryId) const
+{
+    if (this->mTrajectoryIds.empty())
+    {
+        return -1;
+    }
+    if (this->mContiguousIds)
+    {
+        const long tempIndex = static_cast<long>(inTrajectoryId) - this->mTrajectoryIds.front();
+        if (tempIndex < 0 || tempIndex >= static_cast<long>(this->mTrajectoryIds.size()))
+        {
+            return -1;
+        }
+        return static_cast<int>(tempIndex);
+    }
+    std::vector<int>::const_iterator found = std::lower_bound(
+            this->mTrajectoryIds.begin(), this->mTrajectoryIds.end(), inTrajectoryId);
+    if (found == this->mTrajectoryIds.end() || *found != inTrajectoryId)
+    {
+        return -1;
+    }
+    return static_cast<int>(found - this->mTrajectoryIds.begin());
+}
+
+TruthIndex::MatchSlot& TruthIndex::FindSlot(const Cube::ReconObject* inObject) const
+{
+    const std::size_t tempMask = this->mMatches.size() - 1;
+    std::size_t tempSlot = (reinterpret_cast<std::uintptr_t>(inObject) >> 4) * 0x9E3779B97F4A7C15ull;
+    tempSlot = (tempSlot >> 16) & tempMask;
+    while (this->mMatches[tempSlot].object != NULL && this->mMatches[tempSlot].object != inObject)
+    {
+        tempSlot = (tempSlot + 1) & tempMask;
+    }
+    return this->mMatches[tempSlot];
+}
+
+void TruthIndex::InsertMatch(const Cube::ReconObject* inObject, int inTrajectoryId) const
+{
+    if (2 * (this->mUsedSlots.size() + 1) > this->mMatches.size())
+    {
+        std::vector<MatchSlot> tempOldMatches(std::max<std::size_t>(64, 2 * this->mMatches.size()));
+        tempOldMatches.swap(this->mMatches);
+        this->mUsedSlots.clear();
+        for (const MatchSlot& tempMatch : tempOldMatches)
+        {
+            if (tempMatch.object)
+            {
+                MatchSlot& tempSlot = this->FindSlot(tempMatch.object);
+                tempSlot = tempMatch;
+                this->mUsedSlots.push_back(&tempSlot - this->mMatches.data());
+            }
+        }
+    }
+    MatchSlot& tempSlot = this->FindSlot(inObject);
+    if (!tempSlot.object)
+    {
+        tempSlot.object = inObject;
+        this->mUsedSlots.push_back(&tempSlot - this->mMatches.data());
+    }
+    tempSlot.trajectoryId = inTrajectoryId;
+}
+
+int TruthIndex::GetMainTrajectory(const Cube::Handle<Cube::ReconObject>& inObject) const
+{
+    if (!inObject)
+    {
+        return kNoTrajectory;
+    }
+    const Cube::ReconObject* tempKey = &(*inObject);
+    if (!this->mMatches.empty())
+    {
+        const MatchSlot& tempCached = this->FindSlot(tempKey);
+        if (tempCached.object)
+        {
+            return tempCached.trajectoryId;
+        }
+    }
+
+    int tempTrajectoryId = kNoTrajectory;
+    Cube::Handle<Cube::ReconTrack> inTrack = inObject;
+    Cube::Handle<Cube::ReconCluster> inCluster = inObject;
+    if (inTrack)
+    {
+        tempTrajectoryId = Cube::Tool::MainTrajectory(*this->mEvent, *inTrack);
+    }
+    if (inCluster)
+    {
+        tempTrajectoryId = Cube::Tool::MainTrajectory(*this->mEvent, *inCluster);
+    }
+    this->InsertMatch(tempKey, tempTrajectoryId);
+    return tempTrajectoryId;
+}
+
+void TruthIndex::SetMainTrajectory(const Cube::Handle<Cube::ReconObject>& inObject, int inTrajectoryId)
+{
+    if (inObject)
+    {
+        this->InsertMatch(&(*inObject), inTrajectoryId);
+    }
+}
+
+const TruthIndex::TrajectoryInfo* TruthIndex::Find(int inTrajectoryId) const
+{
+    const int tempIndex = this->FindTrajectoryIndex(inTrajectoryId);
+    if (tempIndex < 0)
+    {
+        return NULL;
+    }
+    return &this->mTrajectories[tempIndex];
+}
+
+int TruthIndex::GetPdg(const Cube::Handle<Cube::ReconObject>& inObject) const
+{
+    const TrajectoryInfo* tempInfo = this->Find(this->GetMainTrajectory(inObject));
+    return tempInfo ? tempInfo->pdg : 0;
+}
+
+int TruthIndex::GetParentID(const Cube::Handle<Cube::ReconObject>& inObject) const
+{
+    const TrajectoryInfo* tempInfo = this->Find(this->GetMainTrajectory(inObject));
+    return tempInfo ? tempInfo->parentId : 0;
+}
+
+int TruthIndex::GetTrajectoryPdg(int inTrajectoryId) const
+{
+    const TrajectoryInfo* tempInfo = this->Find(inTrajectoryId);
+    return tempInfo ? tempInfo->pdg : 0;
+}
+
+int TruthIndex::GetPrimaryAncestor(int inTrajectoryId) const
+{
+    const TrajectoryInfo* tempInfo = this->Find(inTrajectoryId);
+    return tempInfo ? tempInfo->primaryId : kNoTrajectory;
+}
+
+bool TruthIndex::IsDescendantOf(int inTrajectoryId, unsigned int inFlags) const
+{
+    const TrajectoryInfo* tempInfo = this->Find(inTrajectoryId);
+    return tempInfo && (tempInfo->ancestorFlags & inFlags) != 0;
+}
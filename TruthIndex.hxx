@@ -0,0 +1,213 @@
+#ifndef TRUTHINDEX_HXX
+#define TRUTHINDEX_HXX
+
+#include <CubeEvent.hxx>
+#include <CubeReconObject.hxx>
+#include <CubeReconCluster.hxx>
+#include <CubeReconTrack.hxx>
+#include <CubeHandle.hxx>
+#include <CubeG4Trajectory.hxx>
+#include <ToolMainTrajectory.hxx>
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief TruthIndex class
+ * @details TruthIndex is built once per event. \n
+ * It has trajectory id -> {pdg, parentId, ancestry} table of
+ * G4Trajectories and object -> main trajectory id cache, so truth
+ * queries cost O(1). \n
+ * Ancestry (primary ancestor, generation depth and pdg flags of all
+ * ancestors) is resolved for every trajectory in Build(), each
+ * trajectory is visited once. \n
+ * Both tables keep their capacity after Clear(), so an index reused
+ * for every event does not allocate in steady state.
+ * @date 2026-10-17
+ */
+class TruthIndex
+{
+    public:
+        /**
+         * @brief truth information of one trajectory
+         */
+        struct TrajectoryInfo
+        {
+            int pdg = 0;
+            int parentId = 0;
+            int primaryId = 0; //id of primary ancestor, own id if primary
+            int depth = 0; //0: primary, 1: child of primary, ...
+            unsigned int ancestorFlags = 0; //AncestorFlag of all ancestors, not of itself
+        };
+
+        /**
+         * @brief particle type flag of ancestors
+         */
+        enum AncestorFlag
+        {
+            kMuonAncestor = 1 << 0,
+            kNeutronAncestor = 1 << 1,
+            kProtonAncestor = 1 << 2,
+            kPionAncestor = 1 << 3,
+            kGammaAncestor = 1 << 4,
+            kElectronAncestor = 1 << 5
+        };
+
+        /**
+         * @brief get AncestorFlag of pdg code
+         * @return unsigned int flag, 0 if pdg code has no flag
+         */
+        static unsigned int GetPdgFlag(int inPdg);
+
+        /**
+         * @brief build trajectory table of the input event
+         * @details previous table and main trajectory cache are cleared.
+         * @param Cube::Event* inEvent: input event
+         */
+        void Build(Cube::Event* inEvent);
+
+        /**
+         * @brief clear trajectory table and main trajectory cache
+         */
+        void Clear();
+
+        /**
+         * @brief get main trajectory id of object
+         * @details Cube::Tool::MainTrajectory is called only the first time
+         * for each object, after that cached value is returned.
+         * @param const Cube::Handle<Cube::ReconObject>& inObject: input object
+         * @return int main trajectory id, kNoTrajectory if object is
+         * empty or neither track nor cluster.
+         */
+        int GetMainTrajectory(const Cube::Handle<Cube::ReconObject>& inObject) const;
+
+        /**
+         * @brief set main trajectory id of object
+         * @details used when truth matching is already known
+         * (e.g. precomputed), so Cube::Tool::MainTrajectory is not called.
+         * @param const Cube::Handle<Cube::ReconObject>& inObject: input object
+         * @param int inTrajectoryId: main trajectory id of inObject
+         */
+        void SetMainTrajectory(const Cube::Handle<Cube::ReconObject>& inObject, int inTrajectoryId);
+
+        /**
+         * @brief find truth information of trajectory
+         * @param int inTrajectoryId: input trajectory id
+         * @return const TrajectoryInfo*, NULL if trajectory is not in this event.
+         */
+        const TrajectoryInfo* Find(int inTrajectoryId) const;
+
+        /**
+         * @brief get pdg code of object
+         * @return int pdg code of main trajectory, 0 if not matched
+         */
+        int GetPdg(const Cube::Handle<Cube::ReconObject>& inObject) const;
+
+        /**
+         * @brief get parent id of object
+         * @return int parent id of main trajectory, 0 if not matched
+         */
+        int GetParentID(const Cube::Handle<Cube::ReconObject>& inObject) const;
+
+        /**
+         * @brief get pdg code of trajectory
+         * @param int inTrajectoryId: input trajectory id (e.g. parentId of object)
+         * @return int pdg code, 0 if trajectory is not in this event
+         */
+        int GetTrajectoryPdg(int inTrajectoryId) const;
+
+        /**
+         * @brief get primary ancestor of trajectory
+         * @return int id of primary ancestor, kNoTrajectory if trajectory
+         * is not in this event
+         */
+        int GetPrimaryAncestor(int inTrajectoryId) const;
+
+        /**
+         * @brief check if trajectory descends from particle
+         * @param int inTrajectoryId: input trajectory id
+         * @param unsigned int inFlags: AncestorFlag, or of several flags
+         * @return bool true if any ancestor (not trajectory itself) has one of inFlags
+         */
+        bool IsDescendantOf(int inTrajectoryId, unsigned int inFlags) const;
+
+        /**
+         * @brief main trajectory id of object which is neither track nor cluster
+         */
+        static const int kNoTrajectory;
+
+    private:
+        /**
+         * @brief event of this index
+         */
+        Cube::Event* mEvent = NULL;
+
+        /**
+         * @brief slot of object -> main trajectory id table
+         */
+        struct MatchSlot
+        {
+            const Cube::ReconObject* object = NULL;
+            int trajectoryId = 0;
+        };
+
+        /**
+         * @brief get position of trajectory in mTrajectoryIds
+         * @return int position, -1 if trajectory is not in this event
+         */
+        int FindTrajectoryIndex(int inTrajectoryId) const;
+
+        /**
+         * @brief resolve primary ancestor, depth and ancestor flags
+         * @details walk up from each unresolved trajectory until a
+         * resolved one or a primary is found, then fill the walked path
+         * from the top. A parent which is not in G4Trajectories is
+         * treated as primary.
+         */
+        void ResolveAncestry();
+
+        /**
+         * @brief get slot of object in mMatches
+         * @return MatchSlot& slot of inObject, or empty slot where it belongs
+         */
+        MatchSlot& FindSlot(const Cube::ReconObject* inObject) const;
+
+        /**
+         * @brief insert object -> main trajectory id
+         */
+        void InsertMatch(const Cube::ReconObject* inObject, int inTrajectoryId) const;
+
+        /**
+         * @brief trajectory ids, ascending (order of G4Trajectories)
+         */
+        std::vector<int> mTrajectoryIds;
+
+        /**
+         * @brief truth information of each trajectory in mTrajectoryIds
+         */
+        std::vector<TrajectoryInfo> mTrajectories;
+
+        /**
+         * @brief positions of trajectories walked by ResolveAncestry()
+         */
+        std::vector<int> mAncestryPath;
+
+        /**
+         * @brief trajectory ids have no gap, position is id - first id
+         */
+        bool mContiguousIds = true;
+
+        /**
+         * @brief object -> main trajectory id, open addressing table
+         * @details size is power of 2, at most half full.
+         */
+        mutable std::vector<MatchSlot> mMatches;
+
+        /**
+         * @brief positions of used slots in mMatches
+         * @details Clear() resets only these slots, not the whole table.
+         */
+        mutable std::vector<std::size_t> mUsedSlots;
+};
+
+#endif
@@ -0,0 +1,213 @@
+#include "TruthSidecar.hxx"
+#include "SkimIndex.hxx"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const int TruthSidecar::kVersion = 2;
+
+namespace
+{
+    static_assert(sizeof(int) == 4, "sidecar columns are int32");
+
+    const char kTruthMagic[16] = "test_analysis-t";
+
+    /**
+     * @brief fixed size header of the sidecar file
+     * @details followed by input key (padded to 8 bytes), numberOfEntries + 1
+     * int64 offsets and one int32 column of numberOfObjects main trajectory ids.
+     */
+    struct Header
+    {
+        char magic[16];
+        std::int32_t version;
+        std::int32_t keyLength;
+        std::int64_t numberOfEntries;
+        std::int64_t numberOfObjects;
+    };
+
+    std::size_t GetPaddedLength(std::size_t inLength)
+    {
+        return (inLength + 7) / 8 * 8;
+    }
+}
+
+TruthSidecar::TruthSidecar(const std::string& inInputFileName)
+    : mInputFileName(inInputFileName)
+      ,mSidecarFileName(inInputFileName + ".truth")
+{
+    this->mAddedOffsets.push_back(0);
+}
+
+TruthSidecar::~TruthSidecar()
+{
+    this->Close();
+}
+
+const std::string& TruthSidecar::GetSidecarFileName() const
+{
+    return this->mSidecarFileName;
+}
+
+void TruthSidecar::Close()
+{
+    if (this->mData)
+    {
+        munmap(this->mData, this->mSize);
+    }
+    this->mData = NULL;
+    this->mSize = 0;
+    this->mNumberOfEntries = 0;
+    this->mOffsets = NULL;
+    this->mMainTrajectories = NULL;
+}
+
+bool TruthSidecar::Open(Long64_t inNumberOfEntries)
+{
+    this->Close();
+    const std::string tempInputKey = SkimIndex::GetInputKey(this->mInputFileName);
+    if (tempInputKey.empty())
+    {
+        return false;
+    }
+
+    const int tempDescriptor = open(this->mSidecarFileName.c_str(), O_RDONLY);
+    if (tempDescriptor < 0)
+    {
+        return false;
+    }
+    struct stat tempStat;
+    if (fstat(tempDescriptor, &tempStat) != 0 || static_cast<std::size_t>(tempStat.st_size) < sizeof(Header))
+    {
+        close(tempDescriptor);
+        return false;
+    }
+    const std::size_t tempSize = tempStat.st_size;
+    void* tempData = mmap(NULL, tempSize, PROT_READ, MAP_PRIVATE, tempDescriptor, 0);
+    // the mapping stays valid after the descriptor is closed
+    close(tempDescriptor);
+    if (tempData == MAP_FAILED)
+    {
+        return false;
+    }
+    this->mData = tempData;
+    this->mSize = tempSize;
+
+    const char* tempBytes = static_cast<const char*>(tempData);
+    Header tempHeader;
+    std::memcpy(&tempHeader, tempBytes, sizeof(Header));
+    const std::size_t tempKeyLength = tempHeader.keyLength < 0 ? 0 : tempHeader.keyLength;
+    const std::size_t tempOffsetsBegin = sizeof(Header) + GetPaddedLength(tempKeyLength);
+    if (std::memcmp(tempHeader.magic, kTruthMagic, sizeof(kTruthMagic)) != 0
+            || tempHeader.version != kVersion
+            || tempHeader.numberOfEntries != inNumberOfEntries
+            || tempHeader.numberOfObjects < 0
+            || tempHeader.numberOfObjects > static_cast<std::int64_t>(tempSize)
+            || tempOffsetsBegin > tempSize
+            || std::string(tempBytes + sizeof(Header), tempKeyLength) != tempInputKey)
+    {
+        this->Close();
+        return false;
+    }
+    const std::size_t tempColumnsBegin = tempOffsetsBegin + (inNumberOfEntries + 1) * sizeof(std::int64_t);
+    const std::size_t tempColumnSize = tempHeader.numberOfObjects * sizeof(int);
+    if (tempColumnsBegin + tempColumnSize != tempSize)
+    {
+        this->Close();
+        return false;
+    }
+
+    this->mNumberOfEntries = inNumberOfEntries;
+    this->mOffsets = reinterpret_cast<const std::int64_t*>(tempBytes + tempOffsetsBegin);
+    this->mMainTrajectories = reinterpret_cast<const int*>(tempBytes + tempColumnsBegin);
+    // offsets are trusted by the getters: non-decreasing from 0 to numberOfObjects
+    bool tempValidOffsets = this->mOffsets[0] == 0 && this->mOffsets[inNumberOfEntries] == tempHeader.numberOfObjects;
+    for (Long64_t i = 0; tempValidOffsets && i < inNumberOfEntries; ++i)
+    {
+        tempValidOffsets = this->mOffsets[i] <= this->mOffsets[i + 1];
+    }
+    if (!tempValidOffsets)
+    {
+        this->Close();
+        return false;
+    }
+    return true;
+}
+
+bool TruthSidecar::IsOpen() const
+{
+    return this->mData != NULL;
+}
+
+std::int64_t TruthSidecar::GetOffset(Long64_t inEntry) const
+{
+    return this->mOffsets[inEntry];
+}
+
+int TruthSidecar::GetNumberOfObjects(Long64_t inEntry) const
+{
+    if (!this->mData || inEntry < 0 || inEntry >= this->mNumberOfEntries)
+    {
+        return -1;
+    }
+    const std::int64_t tempNumberOfObjects = this->GetOffset(inEntry + 1) - this->GetOffset(inEntry);
+    return tempNumberOfObjects < 0 ? -1 : static_cast<int>(tempNumberOfObjects);
+}
+
+const int* TruthSidecar::GetMainTrajectories(Long64_t inEntry) const
+{
+    return this->GetNumberOfObjects(inEntry) < 0 ? NULL : this->mMainTrajectories + this->GetOffset(inEntry);
+}
+
+void TruthSidecar::AddEntry(const ObjectSnapshot& inSnapshot)
+{
+    const std::vector<int>& tempTrajectoryIds = inSnapshot.GetTrajectoryId();
+    this->mAddedMainTrajectories.insert(this->mAddedMainTrajectories.end(), tempTrajectoryIds.begin(), tempTrajectoryIds.end());
+    this->mAddedOffsets.push_back(this->mAddedMainTrajectories.size());
+}
+
+bool TruthSidecar::Save(Long64_t inNumberOfEntries) const
+{
+    const std::string tempInputKey = SkimIndex::GetInputKey(this->mInputFileName);
+    if (tempInputKey.empty() || static_cast<Long64_t>(this->mAddedOffsets.size()) != inNumberOfEntries + 1)
+    {
+        return false;
+    }
+
+    Header tempHeader;
+    std::memset(&tempHeader, 0, sizeof(Header));
+    std::memcpy(tempHeader.magic, kTruthMagic, sizeof(kTruthMagic));
+    tempHeader.version = kVersion;
+    tempHeader.keyLength = tempInputKey.size();
+    tempHeader.numberOfEntries = inNumberOfEntries;
+    tempHeader.numberOfObjects = this->mAddedMainTrajectories.size();
+    const std::string tempPadding(GetPaddedLength(tempInputKey.size()) - tempInputKey.size(), '\0');
+
+    // same as SkimIndex: never leave a truncated sidecar behind
+    const std::string tempFileName = this->mSidecarFileName + ".tmp";
+    {
+        std::ofstream tempFile(tempFileName, std::ios::binary);
+        if (!tempFile)
+        {
+            return false;
+        }
+        tempFile.write(reinterpret_cast<const char*>(&tempHeader), sizeof(Header));
+        tempFile.write(tempInputKey.data(), tempInputKey.size());
+        tempFile.write(tempPadding.data(), tempPadding.size());
+        tempFile.write(reinterpret_cast<const char*>(this->mAddedOffsets.data()),
+                this->mAddedOffsets.size() * sizeof(std::int64_t));
+        tempFile.write(reinterpret_cast<const char*>(this->mAddedMainTrajectories.data()),
+                this->mAddedMainTrajectories.size() * sizeof(int));
+        if (!tempFile)
+        {
+            return false;
+        }
+    }
+    return std::rename(tempFileName.c_str(), this->mSidecarFileName.c_str()) == 0;
+}
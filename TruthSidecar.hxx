@@ -0,0 +1,145 @@
+#ifndef TRUTHSIDECAR_HXX
+#define TRUTHSIDECAR_HXX
+
+#include "ObjectSnapshot.hxx"
+
+#include <Rtypes.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief TruthSidecar class
+ * @details TruthSidecar is a binary sidecar file next to the input file
+ * ("<input>.truth") which has, for every entry and every object of the
+ * object container used by EventAnalysis, the main trajectory id. \n
+ * Ids are stored as one contiguous int32 array, the file is memory
+ * mapped and main trajectories of an entry are passed to
+ * EventAnalysis::CollectObjects() without copy, so
+ * Cube::Tool::MainTrajectory is not called. \n
+ * The sidecar is keyed by input file like SkimIndex, a stale sidecar
+ * is not opened and truth matching is computed as before.
+ * @date 2026-10-17
+ */
+class TruthSidecar
+{
+    public:
+        /**
+         * @brief version of the sidecar layout
+         */
+        static const int kVersion;
+
+        /**
+         * @brief initializer
+         * @param const std::string& inInputFileName: input file of the sidecar
+         */
+        TruthSidecar(const std::string& inInputFileName);
+
+        /**
+         * @brief unmap sidecar file
+         */
+        ~TruthSidecar();
+
+        TruthSidecar(const TruthSidecar&) = delete;
+        TruthSidecar& operator=(const TruthSidecar&) = delete;
+
+        /**
+         * @brief get sidecar file name
+         * @return std::string "<input>.truth"
+         */
+        const std::string& GetSidecarFileName() const;
+
+        /**
+         * @brief map sidecar file
+         * @param Long64_t inNumberOfEntries: number of entries in the input
+         * @return bool false if sidecar is missing, stale, of other
+         * version or truncated
+         */
+        bool Open(Long64_t inNumberOfEntries);
+
+        /**
+         * @brief check if sidecar is mapped
+         */
+        bool IsOpen() const;
+
+        /**
+         * @brief get number of objects of entry
+         * @param Long64_t inEntry: entry of the input file
+         * @return int -1 if sidecar is not mapped or entry is out of range
+         */
+        int GetNumberOfObjects(Long64_t inEntry) const;
+
+        /**
+         * @brief get main trajectory ids of entry, one per object in container order
+         * @details pointer into the mapped file, valid while this is open.
+         * @return const int* NULL if GetNumberOfObjects(inEntry) < 0
+         */
+        const int* GetMainTrajectories(Long64_t inEntry) const;
+
+        /**
+         * @brief append objects of next entry
+         * @details entries should be added in order, starting from 0.
+         * @param const ObjectSnapshot& inSnapshot: snapshot of the entry,
+         * empty if the entry has no object container
+         */
+        void AddEntry(const ObjectSnapshot& inSnapshot);
+
+        /**
+         * @brief save added entries to sidecar file
+         * @return bool false if number of added entries is not
+         * inNumberOfEntries or sidecar cannot be written
+         */
+        bool Save(Long64_t inNumberOfEntries) const;
+
+    private:
+        /**
+         * @brief unmap sidecar file
+         */
+        void Close();
+
+        /**
+         * @brief get row of first object of entry
+         */
+        std::int64_t GetOffset(Long64_t inEntry) const;
+
+        /**
+         * @brief input file name
+         */
+        std::string mInputFileName;
+
+        /**
+         * @brief sidecar file name
+         */
+        std::string mSidecarFileName;
+
+        /**
+         * @brief mapped sidecar file, NULL if not open
+         */
+        void* mData = NULL;
+
+        /**
+         * @brief size of mapped sidecar file
+         */
+        std::size_t mSize = 0;
+
+        /**
+         * @brief number of entries of mapped sidecar file
+         */
+        Long64_t mNumberOfEntries = 0;
+
+        /**
+         * @brief columns in the mapped file
+         */
+        const std::int64_t* mOffsets = NULL;
+        const int* mMainTrajectories = NULL;
+
+        /**
+         * @brief entries added for Save()
+         */
+        std::vector<std::int64_t> mAddedOffsets;
+        std::vector<int> mAddedMainTrajectories;
+};
+
+#endif
@@ -0,0 +1,310 @@
+#include "EventAnalysis.hxx"
+#include "StringUtility.hxx"
+#include "SyntheticEvent.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <getopt.h>
+
+namespace
+{
+    /**
+     * @brief result of benchmark functions, keeps the compiler from
+     * removing the benchmarked calls
+     */
+    volatile long gSink = 0;
+
+    /**
+     * @brief run inFunction inRepetitions times
+     * @return double fastest wall time in seconds
+     */
+    template <class Function>
+    double Measure(int inRepetitions, Function inFunction)
+    {
+        double tempBest = -1;
+        for (int r = 0; r < inRepetitions; ++r)
+        {
+            std::chrono::steady_clock::time_point tempStart = std::chrono::steady_clock::now();
+            inFunction();
+            std::chrono::duration<double> tempElapsed = std::chrono::steady_clock::now() - tempStart;
+            if (tempBest < 0 || tempElapsed.count() < tempBest)
+            {
+                tempBest = tempElapsed.count();
+            }
+        }
+        return tempBest;
+    }
+
+    /**
+     * @brief print one line of result table
+     * @param inCalls: number of benchmarked calls in inSeconds
+     */
+    void Report(const char* inName, int inMultiplicity, int inNumberOfEvents, long inCalls, double inSeconds)
+    {
+        std::printf("%-28s %8d %14.1f %14.1f %12.1f\n",
+                inName, inMultiplicity,
+                inNumberOfEvents / inSeconds,
+                1e9 * inSeconds / inNumberOfEvents,
+                1e9 * inSeconds / std::max(1L, inCalls));
+    }
+
+    /**
+     * @brief analysis of synthetic event, ready for truth queries
+     */
+    std::unique_ptr<EventAnalysis> Prepare(const SyntheticEvent& inEvent)
+    {
+        std::unique_ptr<EventAnalysis> tempEventAnalysis = std::make_unique<EventAnalysis> (inEvent.GetEvent());
+        tempEventAnalysis->SetTruthCounters();
+        Cube::Handle<Cube::AlgorithmResult> topResult(inEvent.GetEvent(), false);
+        tempEventAnalysis->CollectObjects(topResult, inEvent.GetMainTrajectories().data());
+        return tempEventAnalysis;
+    }
+
+    void Usage(const char* inProgram)
+    {
+        std::cout << "usage: " << inProgram << " [-e events] [-r repetitions] [-m m1,m2,...]" << std::endl;
+        std::cout << "    -e N: number of synthetic events per multiplicity (default 200)" << std::endl;
+        std::cout << "    -r N: repetitions of each benchmark, fastest is reported (default 3)" << std::endl;
+        std::cout << "    -m L: comma separated number of objects per event (default 10,100,1000)" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int numberOfEvents = 200;
+    int repetitions = 3;
+    std::vector<int> multiplicities = {10, 100, 1000};
+
+    int option;
+    while ((option = getopt(argc, argv, "e:r:m:h")) != -1)
+    {
+        switch (option)
+        {
+            case 'e':
+                numberOfEvents = std::max(1, std::atoi(optarg));
+                break;
+            case 'r':
+                repetitions = std::max(1, std::atoi(optarg));
+                break;
+            case 'm':
+            {
+                multiplicities.clear();
+                for (const std::string& tempItem : SplitList(optarg))
+                {
+                    multiplicities.push_back(std::max(2, std::atoi(tempItem.c_str())));
+                }
+                break;
+            }
+            default:
+                Usage(argv[0]);
+                return option == 'h' ? 0 : 1;
+        }
+    }
+
+    std::printf("%-28s %8s %14s %14s %12s\n",
+            "benchmark", "objects", "events/s", "ns/event", "ns/call");
+
+    for (int multiplicity : multiplicities)
+    {
+        SyntheticEvent::Config tempConfig;
+        tempConfig.numberOfTracks = std::max(1, multiplicity / 3);
+        tempConfig.numberOfClusters = multiplicity - tempConfig.numberOfTracks;
+        tempConfig.numberOfTrajectories = 2 * multiplicity;
+
+        std::vector<std::unique_ptr<SyntheticEvent>> tempEvents;
+        for (int i = 0; i < numberOfEvents; ++i)
+        {
+            tempConfig.seed = i + 1;
+            tempEvents.push_back(std::make_unique<SyntheticEvent> (tempConfig));
+        }
+
+        std::vector<std::unique_ptr<EventAnalysis>> tempAnalyses;
+        long tempNumberOfObjects = 0;
+        for (const std::unique_ptr<SyntheticEvent>& tempEvent : tempEvents)
+        {
+            tempAnalyses.push_back(Prepare(*tempEvent));
+            tempNumberOfObjects += tempAnalyses.back()->GetTimeOrderedObjects().size();
+        }
+
+        double tempSeconds = Measure(repetitions, [&]()
+                {
+                    for (const std::unique_ptr<EventAnalysis>& tempEventAnalysis : tempAnalyses)
+                    {
+                        for (const auto& tempObject : tempEventAnalysis->GetTimeOrderedObjects())
+                        {
+                            gSink += tempEventAnalysis->GetPdg(tempObject);
+                        }
+                    }
+                });
+        Report("GetPdg", multiplicity, numberOfEvents, tempNumberOfObjects, tempSeconds);
+
+        tempSeconds = Measure(repetitions, [&]()
+                {
+                    for (const std::unique_ptr<EventAnalysis>& tempEventAnalysis : tempAnalyses)
+                    {
+                        for (const auto& tempObject : tempEventAnalysis->GetTimeOrderedObjects())
+                        {
+                            gSink += tempEventAnalysis->GetParentID(tempObject);
+                        }
+                    }
+                });
+        Report("GetParentID", multiplicity, numberOfEvents, tempNumberOfObjects, tempSeconds);
+
+        // SortObjectsByTime is private, it is measured through CollectObjects
+        tempSeconds = Measure(repetitions, [&]()
+                {
+                    for (const std::unique_ptr<SyntheticEvent>& tempEvent : tempEvents)
+                    {
+                        EventAnalysis tempEventAnalysis(tempEvent->GetEvent());
+                        Cube::Handle<Cube::AlgorithmResult> topResult(tempEvent->GetEvent(), false);
+                        tempEventAnalysis.CollectObjects(topResult, tempEvent->GetMainTrajectories().data());
+                        gSink += tempEventAnalysis.GetTimeOrderedObjects().size();
+                    }
+                });
+        Report("CollectObjects+Sort", multiplicity, numberOfEvents, numberOfEvents, tempSeconds);
+
+        tempSeconds = Measure(repetitions, [&]()
+                {
+                    for (const std::unique_ptr<EventAnalysis>& tempEventAnalysis : tempAnalyses)
+                    {
+                        gSink += tempEventAnalysis->SetVertex();
+                    }
+                });
+        Report("SetVertex", multiplicity, numberOfEvents, numberOfEvents, tempSeconds);
+
+        tempSeconds = Measure(repetitions, [&]()
+                {
+                    for (const std::unique_ptr<EventAnalysis>& tempEventAnalysis : tempAnalyses)
+                    {
+                        gSink += tempEventAnalysis->SetFirstObject();
+                    }
+                });
+        Report("SetFirstObject", multiplicity, numberOfEvents, numberOfEvents, tempSeconds);
+
+        SpatialIndex tempSpatialIndex;
+        tempSeconds = Measure(repetitions, [&]()
+                {
+                    for (const std::unique_ptr<EventAnalysis>& tempEventAnalysis : tempAnalyses)
+                    {
+                        tempSpatialIndex.Build(tempEventAnalysis->GetSnapshot());
+                        gSink += tempSpatialIndex.GetSize();
+                    }
+                });
+        Report("SpatialIndex::Build", multiplicity, numberOfEvents, numberOfEvents, tempSeconds);
+
+        // neighbourhood of every object: naive loops against the spatial index
+        const double tempRadius = 100;
+        tempSeconds = Measure(repetitions, [&]()
+                {
+                    for (const std::unique_ptr<EventAnalysis>& tempEventAnalysis : tempAnalyses)
+                    {
+                        const ObjectSnapshot& tempSnapshot = tempEventAnalysis->GetSnapshot();
+                        for (std::size_t i = 0; i < tempSnapshot.GetSize(); ++i)
+                        {
+                            for (std::size_t j = 0; j < tempSnapshot.GetSize(); ++j)
+                            {
+                                const double tempDx = tempSnapshot.GetX()[j] - tempSnapshot.GetX()[i];
+                                const double tempDy = tempSnapshot.GetY()[j] - tempSnapshot.GetY()[i];
+                                const double tempDz = tempSnapshot.GetZ()[j] - tempSnapshot.GetZ()[i];
+                                gSink += tempSnapshot.GetKind()[j] != ObjectSnapshot::kOther
+                                    && tempDx * tempDx + tempDy * tempDy + tempDz * tempDz <= tempRadius * tempRadius;
+                            }
+                        }
+                    }
+                });
+        Report("RadiusQuery (naive)", multiplicity, numberOfEvents, tempNumberOfObjects, tempSeconds);
+
+        tempSeconds = Measure(repetitions, [&]()
+                {
+                    for (const std::unique_ptr<EventAnalysis>& tempEventAnalysis : tempAnalyses)
+                    {
+                        const ObjectSnapshot& tempSnapshot = tempEventAnalysis->GetSnapshot();
+                        const SpatialIndex& tempIndex = tempEventAnalysis->GetSpatialIndex();
+                        for (std::size_t i = 0; i < tempSnapshot.GetSize(); ++i)
+                        {
+                            gSink += tempIndex.CountInRadius(tempSnapshot.GetX()[i], tempSnapshot.GetY()[i],
+                                    tempSnapshot.GetZ()[i], tempRadius, -1);
+                        }
+                    }
+                });
+        Report("RadiusQuery (index)", multiplicity, numberOfEvents, tempNumberOfObjects, tempSeconds);
+
+        tempSeconds = Measure(repetitions, [&]()
+                {
+                    for (const std::unique_ptr<EventAnalysis>& tempEventAnalysis : tempAnalyses)
+                    {
+                        const ObjectSnapshot& tempSnapshot = tempEventAnalysis->GetSnapshot();
+                        for (std::size_t i = 0; i < tempSnapshot.GetSize(); ++i)
+                        {
+                            double tempBest = std::numeric_limits<double>::infinity();
+                            for (std::size_t j = 0; j < tempSnapshot.GetSize(); ++j)
+                            {
+                                const double tempDx = tempSnapshot.GetX()[j] - tempSnapshot.GetX()[i];
+                                const double tempDy = tempSnapshot.GetY()[j] - tempSnapshot.GetY()[i];
+                                const double tempDz = tempSnapshot.GetZ()[j] - tempSnapshot.GetZ()[i];
+                                if (j != i && tempSnapshot.GetKind()[j] == ObjectSnapshot::kTrack)
+                                {
+                                    tempBest = std::min(tempBest, tempDx * tempDx + tempDy * tempDy + tempDz * tempDz);
+                                }
+                            }
+                            gSink += tempBest < 1e6;
+                        }
+                    }
+                });
+        Report("NearestTrack (naive)", multiplicity, numberOfEvents, tempNumberOfObjects, tempSeconds);
+
+        tempSeconds = Measure(repetitions, [&]()
+                {
+                    for (const std::unique_ptr<EventAnalysis>& tempEventAnalysis : tempAnalyses)
+                    {
+                        const ObjectSnapshot& tempSnapshot = tempEventAnalysis->GetSnapshot();
+                        const SpatialIndex& tempIndex = tempEventAnalysis->GetSpatialIndex();
+                        for (std::size_t i = 0; i < tempSnapshot.GetSize(); ++i)
+                        {
+                            gSink += tempIndex.FindNearest(tempSnapshot.GetX()[i], tempSnapshot.GetY()[i],
+                                    tempSnapshot.GetZ()[i], ObjectSnapshot::kTrack, static_cast<int>(i)) >= 0;
+                        }
+                    }
+                });
+        Report("NearestTrack (index)", multiplicity, numberOfEvents, tempNumberOfObjects, tempSeconds);
+
+        // one analysis is reused for all events, as in the event loop
+        EventAnalysis tempPipelineAnalysis(NULL);
+        tempSeconds = Measure(repetitions, [&]()
+                {
+                    for (const std::unique_ptr<SyntheticEvent>& tempEvent : tempEvents)
+                    {
+                        tempPipelineAnalysis.Reset(tempEvent->GetEvent());
+                        tempPipelineAnalysis.SetTruthCounters();
+                        if (tempPipelineAnalysis.GetNumberOfPrimaryPionTrajectory() != 0 || tempPipelineAnalysis.GetNumberOfPrimaryAntiMuonTrajectory() != 1)
+                        {
+                            continue;
+                        }
+                        Cube::Handle<Cube::AlgorithmResult> topResult(tempEvent->GetEvent(), false);
+                        if (tempPipelineAnalysis.CollectObjects(topResult, tempEvent->GetMainTrajectories().data()) != EventAnalysis::kSuccess)
+                        {
+                            continue;
+                        }
+                        if (tempPipelineAnalysis.SetNumberOfPrimaryAntiMuonObject() != 1)
+                        {
+                            continue;
+                        }
+                        if (tempPipelineAnalysis.SetVertex() != EventAnalysis::kSuccess
+                                || tempPipelineAnalysis.SetFirstObject() != EventAnalysis::kSuccess)
+                        {
+                            continue;
+                        }
+                        gSink += tempPipelineAnalysis.GetPdg(tempPipelineAnalysis.GetFirstObject());
+                    }
+                });
+        Report("full pipeline", multiplicity, numberOfEvents, numberOfEvents, tempSeconds);
+    }
+    return 0;
+}
@@ -1,4 +1,6 @@
-#include "EventAnalysis.hxx"
+#include "EventLoop.hxx"
+#include "SelectionPrompt.hxx"
+#include "StringUtility.hxx"
 
 #include <TFile.h>
 #include <TObject.h>
@@ -13,107 +15,271 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <chrono>
 #include <thread>
 #include <getopt.h>
+#include <glob.h>
 #include <iostream>
 #include <memory>
+#include <vector>
 
-std::unique_ptr<TChain> gCubeReconTree = NULL;
-
-std::unique_ptr<TH1F> deltaTNeutron = std::make_unique<TH1F> ("","#delta T, neutron",100,-10,10);
-std::unique_ptr<TH1F> deltaTOther = std::make_unique<TH1F> ("","#delta T, other",100,-10,10);
-
-void Run(std::string fileName);
-
-int main(int argc, char** argv)
+void Usage(const char* inProgram)
 {
-    std::string fileName = "";
+    std::cout << "usage: " << inProgram << " [options] input-file ..." << std::endl;
+    std::cout << "    -i, --input P:        add input files matching P (may be repeated)" << std::endl;
+    std::cout << "    -j, --threads N:      run with N worker threads (0: number of cores)" << std::endl;
+    std::cout << "    -u, --unordered:      write event output as soon as it is ready" << std::endl;
+    std::cout << "    -o, --output F:       write summary of selected events to ntuple file F" << std::endl;
+    std::cout << "    -q, --quiet:          do not write per event text output, same as -v 1" << std::endl;
+    std::cout << "    -v, --verbosity N:    0: nothing, 1: errors, 2: selected events, 3: all objects (default)" << std::endl;
+    std::cout << "    -k, --skim:           read only entries of the skim index, create it if missing" << std::endl;
+    std::cout << "    -w, --slim F:         write selected events to slimmed file F" << std::endl;
+    std::cout << "    -s, --stats F:        write cut flow and timing report to JSON file F" << std::endl;
+    std::cout << "    -c, --cache-size MB:  TTreeCache size per worker (0: no cache, default 32)" << std::endl;
+    std::cout << "    -l, --learn-entries N: entries of the TTreeCache learning phase (default 10)" << std::endl;
+    std::cout << "    -n, --no-prefetch:    disable asynchronous prefetching" << std::endl;
+    std::cout << "    -b, --branches L:     read only comma separated branch patterns L" << std::endl;
+    std::cout << "    -e, --entries A:B:    analyze only entries [A, B), A or B may be omitted" << std::endl;
+    std::cout << "    -d, --shard I/N:      analyze only shard I of N of the entries" << std::endl;
+    std::cout << "    -p, --checkpoint F:   save checkpoint to F and resume from it" << std::endl;
+    std::cout << "    -P, --checkpoint-every N: entries between checkpoints (default 100000)" << std::endl;
+    std::cout << "    -t, --truth-sidecar:  read truth matching from sidecar files of the inputs" << std::endl;
+    std::cout << "    -T, --make-truth-sidecar: write truth matching sidecar files of the inputs and exit" << std::endl;
+    std::cout << "    -r, --reselect F:     load all entries in memory and run selection commands of" << std::endl;
+    std::cout << "                          script F (-: prompt), instead of the event loop" << std::endl;
+}
 
-    // Check if there is an input file on the command line.
-    if (argc - optind > 0) {
-        fileName = argv[optind];
+/**
+ * @brief parse entry range "first:last"
+ * @details empty first is 0, empty last is -1 (all entries).
+ * @return bool false if inRange is not a valid range
+ */
+bool ParseEntryRange(const std::string& inRange, Long64_t& outFirst, Long64_t& outLast)
+{
+    const std::string::size_type tempColon = inRange.find(':');
+    if (tempColon == std::string::npos)
+    {
+        return false;
     }
-
-    Run(fileName);
-
-    TCanvas can1;
-    deltaTNeutron->Draw();
-    can1.SaveAs("deltaTNeutron.pdf");
-
-    TCanvas can2;
-    deltaTOther->Draw();
-    can2.SaveAs("deltaTOther.pdf");
-    return 0;
+    const std::string tempFirst = inRange.substr(0, tempColon);
+    const std::string tempLast = inRange.substr(tempColon + 1);
+    outFirst = tempFirst.empty() ? 0 : std::atoll(tempFirst.c_str());
+    outLast = tempLast.empty() ? -1 : std::atoll(tempLast.c_str());
+    return outFirst >= 0 && (outLast < 0 || outLast >= outFirst);
 }
 
-void Run(std::string fileName)
+/**
+ * @brief expand shell wildcards of input pattern
+ * @details patterns without local match (e.g. root:// urls) are
+ * returned unchanged, TChain handles them.
+ */
+void AddInputFiles(const std::string& inPattern, std::vector<std::string>& outFileNames)
 {
-    gCubeReconTree = std::make_unique<TChain> ("CubeEvents"); 
-    gCubeReconTree->Add(fileName.c_str());
-
-    if (!gCubeReconTree) 
+    glob_t tempGlob;
+    if (glob(inPattern.c_str(), 0, NULL, &tempGlob) == 0)
+    {
+        for (size_t i = 0; i < tempGlob.gl_pathc; ++i)
+        {
+            outFileNames.push_back(tempGlob.gl_pathv[i]);
+        }
+    }
+    else
     {
-        std::cout << "Missing the event tree" << std::endl;
-        return;
+        outFileNames.push_back(inPattern);
     }
+    globfree(&tempGlob);
+}
 
-    gCubeReconTree->SetBranchAddress("Event",&gEvent);
-    std::cout<<"total number of events : "<<gCubeReconTree->GetEntries()<<std::endl;
+int main(int argc, char** argv)
+{
+    std::vector<std::string> fileNames;
+    int numberOfThreads = 1;
+    bool ordered = true;
+    std::string summaryFileName = "";
+    int verbosity = Logger::kObjects;
+    bool skim = false;
+    std::string slimFileName = "";
+    std::string statisticsFileName = "";
+    Long64_t cacheSize = 32 * 1024 * 1024;
+    Int_t learnEntries = 10;
+    bool prefetch = true;
+    std::vector<std::string> branches;
+    Long64_t firstEntry = 0;
+    Long64_t lastEntry = -1;
+    int shard = 0;
+    int numberOfShards = 1;
+    std::string checkpointFileName = "";
+    Long64_t checkpointInterval = 100000;
+    bool truthSidecar = false;
+    bool makeTruthSidecar = false;
+    std::string reselectFileName = "";
+
+    const struct option longOptions[] = {
+        {"input", required_argument, NULL, 'i'},
+        {"threads", required_argument, NULL, 'j'},
+        {"unordered", no_argument, NULL, 'u'},
+        {"output", required_argument, NULL, 'o'},
+        {"quiet", no_argument, NULL, 'q'},
+        {"verbosity", required_argument, NULL, 'v'},
+        {"skim", no_argument, NULL, 'k'},
+        {"slim", required_argument, NULL, 'w'},
+        {"stats", required_argument, NULL, 's'},
+        {"cache-size", required_argument, NULL, 'c'},
+        {"learn-entries", required_argument, NULL, 'l'},
+        {"no-prefetch", no_argument, NULL, 'n'},
+        {"branches", required_argument, NULL, 'b'},
+        {"entries", required_argument, NULL, 'e'},
+        {"shard", required_argument, NULL, 'd'},
+        {"checkpoint", required_argument, NULL, 'p'},
+        {"checkpoint-every", required_argument, NULL, 'P'},
+        {"truth-sidecar", no_argument, NULL, 't'},
+        {"make-truth-sidecar", no_argument, NULL, 'T'},
+        {"reselect", required_argument, NULL, 'r'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
 
-    //for (Int_t i = 0; i< 10; i++)
-    for (Int_t i = 0; i< gCubeReconTree->GetEntries(); i++)
+    int option;
+    while ((option = getopt_long(argc, argv, "i:j:uo:qv:kw:s:c:l:nb:e:d:p:P:tTr:h", longOptions, NULL)) != -1)
     {
-        gCubeReconTree->GetEntry(i);
-        Cube::Handle<Cube::AlgorithmResult> topResult(gEvent,false);
-        std::unique_ptr<EventAnalysis> tempEventAnalysis = NULL;
-        try
+        switch (option)
         {
-            tempEventAnalysis = std::make_unique<EventAnalysis> (topResult);
-        }
-        catch (const std::runtime_error& e)
-        {
-            std::cout << "exceptrion in event: " << i << ", " << e.what() << std::endl;
-            std::cout << "--------------------------------" << std::endl;
-            continue;
+            case 'i':
+                AddInputFiles(optarg, fileNames);
+                break;
+            case 'j':
+                numberOfThreads = std::atoi(optarg);
+                break;
+            case 'u':
+                ordered = false;
+                break;
+            case 'o':
+                summaryFileName = optarg;
+                break;
+            case 'q':
+                verbosity = Logger::kError;
+                break;
+            case 'v':
+                verbosity = std::atoi(optarg);
+                break;
+            case 'k':
+                skim = true;
+                break;
+            case 'w':
+                slimFileName = optarg;
+                break;
+            case 's':
+                statisticsFileName = optarg;
+                break;
+            case 'c':
+                cacheSize = static_cast<Long64_t>(std::atof(optarg) * 1024 * 1024);
+                break;
+            case 'l':
+                learnEntries = std::atoi(optarg);
+                break;
+            case 'n':
+                prefetch = false;
+                break;
+            case 'b':
+                branches = SplitList(optarg);
+                break;
+            case 'e':
+                if (!ParseEntryRange(optarg, firstEntry, lastEntry))
+                {
+                    std::cout << "invalid entry range: " << optarg << std::endl;
+                    return 1;
+                }
+                break;
+            case 'd':
+                if (std::sscanf(optarg, "%d/%d", &shard, &numberOfShards) != 2
+                        || numberOfShards < 1 || shard < 0 || shard >= numberOfShards)
+                {
+                    std::cout << "invalid shard: " << optarg << std::endl;
+                    return 1;
+                }
+                break;
+            case 'p':
+                checkpointFileName = optarg;
+                break;
+            case 'P':
+                checkpointInterval = std::max(1LL, std::atoll(optarg));
+                break;
+            case 't':
+                truthSidecar = true;
+                break;
+            case 'T':
+                makeTruthSidecar = true;
+                break;
+            case 'r':
+                reselectFileName = optarg;
+                break;
+            default:
+                Usage(argv[0]);
+                return option == 'h' ? 0 : 1;
         }
+    }
 
-        //CC0pi, true selection
-        if (tempEventAnalysis->GetNumberOfPrimaryPionTrajectory() != 0 || tempEventAnalysis->GetNumberOfPrimaryAntiMuonTrajectory() != 1)
-        {
-            continue;
-        }
+    // Input files on the command line.
+    for (int i = optind; i < argc; ++i)
+    {
+        AddInputFiles(argv[i], fileNames);
+    }
 
-        tempEventAnalysis->SetNumberOfPrimaryAntiMuonObject();
-        //seletion of single muon track event
-        if (tempEventAnalysis->GetNumberOfPrimaryAntiMuonObject() != 1)
+    EventLoop eventLoop(fileNames, numberOfThreads, ordered);
+    eventLoop.SetReadCache(cacheSize, learnEntries);
+    eventLoop.SetPrefetch(prefetch);
+    eventLoop.SetBranches(branches);
+    eventLoop.SetSummaryFile(summaryFileName);
+    eventLoop.SetVerbosity(verbosity);
+    eventLoop.SetSkim(skim);
+    eventLoop.SetSlimFile(slimFileName);
+    eventLoop.SetStatisticsFile(statisticsFileName);
+    eventLoop.SetEntryRange(firstEntry, lastEntry);
+    eventLoop.SetShard(shard, numberOfShards);
+    eventLoop.SetCheckpoint(checkpointFileName, checkpointInterval);
+    if (makeTruthSidecar)
+    {
+        return eventLoop.MakeTruthSidecars() ? 0 : 1;
+    }
+    eventLoop.SetTruthSidecar(truthSidecar);
+    if (!reselectFileName.empty())
+    {
+        EventStore eventStore;
+        if (!eventLoop.FillEventStore(eventStore))
         {
-            continue;
+            return 1;
         }
-        std::cout << "event: " << i << std::endl;
-        //std::cout << "number of primary muon track: " << tempEventAnalysis->GetNumberOfPrimaryAntiMuonObject() << std::endl;
-        try
+        SelectionPrompt selectionPrompt(eventStore, numberOfThreads);
+        if (reselectFileName == "-")
         {
-            tempEventAnalysis->SetVertex();
-            tempEventAnalysis->SetFirstObject();
+            return selectionPrompt.Run(std::cin, std::cout, true) ? 0 : 1;
         }
-        catch (const std::runtime_error& e)
+        std::ifstream script(reselectFileName);
+        if (!script)
         {
-            std::cout << e.what() << std::endl;
-            std::cout << "--------------------------------" << std::endl;
-            continue;
+            std::cout << "cannot open " << reselectFileName << std::endl;
+            return 1;
         }
+        return selectionPrompt.Run(script, std::cout, false) ? 0 : 1;
+    }
+    if (!eventLoop.Run())
+    {
+        return 1;
+    }
 
-        TLorentzVector vertex = tempEventAnalysis->GetVertex();
-        Cube::Handle<Cube::ReconTrack> tempFirstTrack = tempEventAnalysis->GetFirstObject();
-        Cube::Handle<Cube::ReconCluster> tempFirstCluster= tempEventAnalysis->GetFirstObject();
+    // shards of one range run side by side, each draws to its own files
+    const std::string suffix = numberOfShards > 1 ? "_shard" + std::to_string(shard) : "";
+    TCanvas can1;
+    eventLoop.GetDeltaTNeutron()->Draw();
+    can1.SaveAs(("deltaTNeutron" + suffix + ".pdf").c_str());
 
-        tempEventAnalysis->ShowAllObjects();
-        tempEventAnalysis->ShowFirstObject();
-        tempEventAnalysis->ShowVertex();
-        std::cout << "--------------------------------" << std::endl;
-    }
+    TCanvas can2;
+    eventLoop.GetDeltaTOther()->Draw();
+    can2.SaveAs(("deltaTOther" + suffix + ".pdf").c_str());
+    return 0;
 }
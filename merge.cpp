@@ -0,0 +1,178 @@
+#include <TFile.h>
+#include <TChain.h>
+#include <TTree.h>
+#include <TH1.h>
+#include <Rtypes.h>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief merge outputs of sharded test_analysis runs
+ * @details outputs (-o files) are ordered by the first entry of their
+ * ShardInfo, not by command line order, so the merged output is the
+ * same for any order of inputs. Histograms and cut flow are summed,
+ * AnalysisSummary and ShardInfo trees are concatenated.
+ */
+
+namespace
+{
+    /**
+     * @brief one shard output
+     */
+    struct ShardOutput
+    {
+        std::string fileName;
+        Long64_t first = 0;
+        Long64_t last = 0;
+    };
+
+    void Usage(const char* inProgram)
+    {
+        std::cout << "usage: " << inProgram << " output-file shard-output ..." << std::endl;
+    }
+
+    /**
+     * @brief read entry range of shard output
+     * @return bool false if file has no ShardInfo
+     */
+    bool ReadShardInfo(const std::string& inFileName, ShardOutput& outShard)
+    {
+        std::unique_ptr<TFile> tempFile(TFile::Open(inFileName.c_str(), "READ"));
+        if (!tempFile || tempFile->IsZombie())
+        {
+            return false;
+        }
+        TTree* tempShardInfo = static_cast<TTree*>(tempFile->Get("ShardInfo"));
+        if (!tempShardInfo || tempShardInfo->GetEntries() < 1)
+        {
+            return false;
+        }
+        Long64_t tempFirst = 0;
+        Long64_t tempLast = 0;
+        tempShardInfo->SetBranchAddress("first", &tempFirst);
+        tempShardInfo->SetBranchAddress("last", &tempLast);
+        tempShardInfo->GetEntry(0);
+        outShard.fileName = inFileName;
+        outShard.first = tempFirst;
+        outShard.last = tempLast;
+        return true;
+    }
+
+    /**
+     * @brief sum histogram of all shard outputs
+     * @return std::unique_ptr<TH1> NULL if no shard output has the histogram
+     */
+    std::unique_ptr<TH1> SumHistogram(const std::vector<ShardOutput>& inShards, const char* inName)
+    {
+        std::unique_ptr<TH1> tempSum;
+        for (const ShardOutput& tempShard : inShards)
+        {
+            std::unique_ptr<TFile> tempFile(TFile::Open(tempShard.fileName.c_str(), "READ"));
+            TH1* tempHistogram = tempFile ? static_cast<TH1*>(tempFile->Get(inName)) : NULL;
+            if (!tempHistogram)
+            {
+                continue;
+            }
+            if (!tempSum)
+            {
+                tempSum.reset(static_cast<TH1*>(tempHistogram->Clone(inName)));
+                tempSum->SetDirectory(NULL);
+            }
+            else
+            {
+                tempSum->Add(tempHistogram);
+            }
+        }
+        return tempSum;
+    }
+
+    /**
+     * @brief concatenate tree of all shard outputs in shard order
+     * @details outFile should be the current directory.
+     */
+    void MergeTree(const std::vector<ShardOutput>& inShards, const char* inName, TFile& outFile)
+    {
+        TChain tempChain(inName);
+        for (const ShardOutput& tempShard : inShards)
+        {
+            tempChain.Add(tempShard.fileName.c_str());
+        }
+        if (tempChain.GetEntries() <= 0)
+        {
+            return;
+        }
+        outFile.cd();
+        TTree* tempTree = tempChain.CloneTree(-1, "fast");
+        if (tempTree)
+        {
+            tempTree->Write();
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+    const std::string outputFileName = argv[1];
+
+    std::vector<ShardOutput> shards;
+    for (int i = 2; i < argc; ++i)
+    {
+        ShardOutput tempShard;
+        if (!ReadShardInfo(argv[i], tempShard))
+        {
+            std::cout << "not a test_analysis output: " << argv[i] << std::endl;
+            return 1;
+        }
+        shards.push_back(tempShard);
+    }
+    std::sort(shards.begin(), shards.end(),
+            [](const ShardOutput& a, const ShardOutput& b)
+            {
+                return a.first < b.first || (a.first == b.first && a.fileName < b.fileName);
+            });
+
+    for (std::size_t i = 1; i < shards.size(); ++i)
+    {
+        if (shards[i].first < shards[i - 1].last)
+        {
+            std::cout << "warning: overlapping entries in " << shards[i - 1].fileName
+                << " and " << shards[i].fileName << std::endl;
+        }
+        else if (shards[i].first > shards[i - 1].last)
+        {
+            std::cout << "warning: entries [" << shards[i - 1].last << ", " << shards[i].first
+                << ") are missing" << std::endl;
+        }
+    }
+
+    std::unique_ptr<TFile> outputFile(TFile::Open(outputFileName.c_str(), "RECREATE"));
+    if (!outputFile || outputFile->IsZombie())
+    {
+        std::cout << "cannot open " << outputFileName << std::endl;
+        return 1;
+    }
+    MergeTree(shards, "AnalysisSummary", *outputFile);
+    MergeTree(shards, "ShardInfo", *outputFile);
+    for (const char* tempName : {"deltaTNeutron", "deltaTOther", "cutFlow"})
+    {
+        std::unique_ptr<TH1> tempSum = SumHistogram(shards, tempName);
+        if (tempSum)
+        {
+            outputFile->WriteTObject(tempSum.get(), tempName, "Overwrite");
+        }
+    }
+    outputFile->Close();
+
+    std::cout << "merged " << shards.size() << " output(s), entries ["
+        << shards.front().first << ", " << shards.back().last << ") to " << outputFileName << std::endl;
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include "Test.hxx"
+
+#include "Checkpoint.hxx"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const std::string kFileName = "test_analysis_test.checkpoint";
+
+    /**
+     * @brief state of a run after some blocks
+     */
+    CheckpointState MakeState(Long64_t inNext)
+    {
+        CheckpointState tempState;
+        tempState.inputFiles = {"/data/run 1.root", "/data/run2.root"};
+        tempState.numberOfEntries = 1000;
+        tempState.first = 100;
+        tempState.last = 900;
+        tempState.next = inNext;
+        tempState.numberOfSummaryRows = inNext / 10;
+        for (int i = 0; i < 102; ++i)
+        {
+            tempState.deltaTNeutron.push_back(i * 0.1);
+            tempState.deltaTOther.push_back(1.0 / (i + 1));
+        }
+        tempState.passed = {inNext, inNext / 2, inNext / 3};
+        return tempState;
+    }
+
+    void CheckSameState(const CheckpointState& inState, const CheckpointState& inOtherState)
+    {
+        CHECK(Checkpoint::IsSameRun(inState, inOtherState));
+        CHECK(inState.inputFiles == inOtherState.inputFiles);
+        CHECK(inState.next == inOtherState.next);
+        CHECK(inState.numberOfSummaryRows == inOtherState.numberOfSummaryRows);
+        CHECK(inState.deltaTNeutron == inOtherState.deltaTNeutron);
+        CHECK(inState.deltaTOther == inOtherState.deltaTOther);
+        CHECK(inState.passed == inOtherState.passed);
+    }
+}
+
+TEST_CASE(CheckpointRoundTrip)
+{
+    Checkpoint tempCheckpoint(kFileName);
+    tempCheckpoint.Remove();
+
+    std::vector<Long64_t> tempSelected = {101, 105, 150};
+    CHECK(tempCheckpoint.Save(MakeState(200), tempSelected));
+    tempSelected.push_back(230);
+    tempSelected.push_back(299);
+    const CheckpointState tempSavedState = MakeState(300);
+    CHECK(tempCheckpoint.Save(tempSavedState, tempSelected));
+
+    Checkpoint tempResumed(kFileName);
+    CheckpointState tempState;
+    std::vector<Long64_t> tempLoadedSelected;
+    CHECK(tempResumed.Load(tempState, tempLoadedSelected));
+    CheckSameState(tempState, tempSavedState);
+    CHECK(tempState.numberOfSelected == 5);
+    CHECK(tempLoadedSelected == tempSelected);
+
+    // the resumed run appends after the loaded entries
+    tempLoadedSelected.push_back(420);
+    CHECK(tempResumed.Save(MakeState(500), tempLoadedSelected));
+    CHECK(Checkpoint(kFileName).Load(tempState, tempSelected));
+    CHECK(tempSelected == tempLoadedSelected);
+
+    tempResumed.Remove();
+    CHECK(!Checkpoint(kFileName).Load(tempState, tempSelected));
+}
+
+TEST_CASE(CheckpointIgnoresIncompleteSave)
+{
+    Checkpoint tempCheckpoint(kFileName);
+    tempCheckpoint.Remove();
+    const std::vector<Long64_t> tempSelected = {101, 105};
+    CHECK(tempCheckpoint.Save(MakeState(200), tempSelected));
+
+    // entries of a save which stopped before the checkpoint was replaced
+    {
+        std::ofstream tempFile(kFileName + ".selected", std::ios::app | std::ios::binary);
+        const Long64_t tempEntry = 250;
+        tempFile.write(reinterpret_cast<const char*>(&tempEntry), sizeof(tempEntry));
+    }
+    Checkpoint tempResumed(kFileName);
+    CheckpointState tempState;
+    std::vector<Long64_t> tempLoadedSelected;
+    CHECK(tempResumed.Load(tempState, tempLoadedSelected));
+    CHECK(tempLoadedSelected == tempSelected);
+
+    // the next save overwrites the stale entry
+    tempLoadedSelected.push_back(260);
+    CHECK(tempResumed.Save(MakeState(300), tempLoadedSelected));
+    std::vector<Long64_t> tempReloaded;
+    CHECK(Checkpoint(kFileName).Load(tempState, tempReloaded));
+    CHECK(tempReloaded == tempLoadedSelected);
+
+    // a selected file shorter than the checkpoint is rejected
+    std::ofstream(kFileName + ".selected", std::ios::trunc | std::ios::binary);
+    CHECK(!Checkpoint(kFileName).Load(tempState, tempReloaded));
+    tempResumed.Remove();
+}
@@ -0,0 +1,85 @@
+#include "Test.hxx"
+
+#include "EventAnalysis.hxx"
+#include "SyntheticEvent.hxx"
+
+#include <cmath>
+#include <limits>
+#include <memory>
+
+namespace
+{
+    /**
+     * @brief analysis of synthetic event, objects collected
+     */
+    std::unique_ptr<EventAnalysis> Prepare(const SyntheticEvent& inEvent)
+    {
+        std::unique_ptr<EventAnalysis> tempEventAnalysis = std::make_unique<EventAnalysis> (inEvent.GetEvent());
+        tempEventAnalysis->SetTruthCounters();
+        Cube::Handle<Cube::AlgorithmResult> topResult(inEvent.GetEvent(), false);
+        tempEventAnalysis->CollectObjects(topResult, inEvent.GetMainTrajectories().data(),
+                inEvent.GetMainTrajectories().size());
+        return tempEventAnalysis;
+    }
+
+    /**
+     * @brief true if any ancestor of inTrajectoryId (not itself) is a muon,
+     * by walking parents of G4Trajectories
+     */
+    bool IsMuonDescendant(Cube::Event* inEvent, int inTrajectoryId)
+    {
+        Cube::Event::G4TrajectoryContainer::iterator it = inEvent->G4Trajectories.find(inTrajectoryId);
+        while (it != inEvent->G4Trajectories.end())
+        {
+            it = inEvent->G4Trajectories.find(it->second->GetParentId());
+            if (it != inEvent->G4Trajectories.end() && std::abs(it->second->GetPDGCode()) == 13)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+TEST_CASE(EventAnalysisFindsVertexAndFirstObject)
+{
+    for (unsigned int seed = 1; seed <= 20; ++seed)
+    {
+        SyntheticEvent::Config tempConfig;
+        tempConfig.seed = seed;
+        SyntheticEvent tempEvent(tempConfig);
+        std::unique_ptr<EventAnalysis> tempEventAnalysis = Prepare(tempEvent);
+
+        CHECK(tempEventAnalysis->GetNumberOfPrimaryAntiMuonTrajectory() == 1);
+        CHECK(tempEventAnalysis->GetObjects()->size() == tempEvent.GetMainTrajectories().size());
+        CHECK(tempEventAnalysis->SetNumberOfPrimaryAntiMuonObject() == 1);
+
+        // the anti muon track is the first object of the container
+        Cube::Handle<Cube::ReconTrack> tempMuonTrack = (*tempEventAnalysis->GetObjects())[0];
+        CHECK(tempEventAnalysis->SetVertex() == EventAnalysis::kSuccess);
+        CHECK(tempEventAnalysis->GetVertex() == tempMuonTrack->GetPosition());
+
+        // brute force: earliest object which is not the anti muon and does
+        // not descend from a muon
+        int tempExpected = -1;
+        double tempEarliest = std::numeric_limits<double>::infinity();
+        for (std::size_t i = 0; i < tempEvent.GetMainTrajectories().size(); ++i)
+        {
+            const int tempTrajectoryId = tempEvent.GetMainTrajectories()[i];
+            const int tempPdg = tempEvent.GetEvent()->G4Trajectories[tempTrajectoryId]->GetPDGCode();
+            const double tempTime = EventAnalysis::GetObjectPosition((*tempEventAnalysis->GetObjects())[i]).T();
+            if (tempPdg == -13 || IsMuonDescendant(tempEvent.GetEvent(), tempTrajectoryId))
+            {
+                continue;
+            }
+            if (tempTime < tempEarliest)
+            {
+                tempEarliest = tempTime;
+                tempExpected = i;
+            }
+        }
+        const EventAnalysis::Status tempStatus = tempEventAnalysis->SetFirstObject();
+        CHECK(tempStatus == (tempExpected < 0 ? EventAnalysis::kNoFirstObjectCandidate : EventAnalysis::kSuccess));
+        CHECK(tempEventAnalysis->GetFirstObjectIndex() == tempExpected);
+    }
+}
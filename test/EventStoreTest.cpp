@@ -0,0 +1,58 @@
+#include "Test.hxx"
+
+#include "EventStore.hxx"
+#include "SyntheticEvent.hxx"
+
+#include <memory>
+#include <vector>
+
+TEST_CASE(EventStoreDefaultSelectionMatchesEventAnalysis)
+{
+    // first objects of EventAnalysis, as in the event loop, and of the
+    // default selection of EventStore on the same events
+    EventStore tempStore;
+    HistogramBuffer tempNeutron(100, -100, 100);
+    HistogramBuffer tempOther(100, -100, 100);
+    Long64_t tempNumberOfFirstObjects = 0;
+    Long64_t tempNumberOfNeutrons = 0;
+    for (unsigned int seed = 1; seed <= 100; ++seed)
+    {
+        SyntheticEvent::Config tempConfig;
+        tempConfig.seed = seed;
+        tempConfig.numberOfTracks = 1 + seed % 7;
+        tempConfig.numberOfClusters = seed % 5;
+        tempConfig.numberOfTrajectories = 2 + seed % 13;
+        SyntheticEvent tempEvent(tempConfig);
+
+        EventAnalysis tempEventAnalysis(tempEvent.GetEvent());
+        tempEventAnalysis.SetTruthCounters();
+        Cube::Handle<Cube::AlgorithmResult> topResult(tempEvent.GetEvent(), false);
+        const bool tempHasObjects = tempEventAnalysis.CollectObjects(topResult, tempEvent.GetMainTrajectories().data(),
+                tempEvent.GetMainTrajectories().size()) == EventAnalysis::kSuccess;
+        CHECK(tempHasObjects);
+        tempEventAnalysis.SetNumberOfPrimaryAntiMuonObject();
+        const bool tempHasVertex = tempEventAnalysis.SetVertex() == EventAnalysis::kSuccess;
+        tempStore.Add(tempEventAnalysis, seed, tempHasObjects, tempHasVertex);
+
+        if (tempHasVertex && tempEventAnalysis.SetFirstObject() == EventAnalysis::kSuccess)
+        {
+            ++tempNumberOfFirstObjects;
+            tempNumberOfNeutrons += tempEventAnalysis.IsFirstObjectFromNeutron();
+            HistogramBuffer& tempDeltaT = tempEventAnalysis.IsFirstObjectFromNeutron() ? tempNeutron : tempOther;
+            tempDeltaT.Fill(tempEventAnalysis.GetFirstObjectDeltaT());
+        }
+    }
+    CHECK(tempNumberOfFirstObjects > 0);
+
+    for (int tempNumberOfThreads : {1, 3})
+    {
+        HistogramBuffer tempStoreNeutron(100, -100, 100);
+        HistogramBuffer tempStoreOther(100, -100, 100);
+        const EventStore::Result tempResult = tempStore.Select(EventStore::Selection(), tempNumberOfThreads,
+                EventStore::kDeltaT, &tempStoreNeutron, &tempStoreOther);
+        CHECK(tempResult.passed[RunStatistics::kFirstObjectCandidate] == tempNumberOfFirstObjects);
+        CHECK(tempResult.neutron == tempNumberOfNeutrons);
+        CHECK(tempStoreNeutron.GetContents() == tempNeutron.GetContents());
+        CHECK(tempStoreOther.GetContents() == tempOther.GetContents());
+    }
+}
@@ -0,0 +1,120 @@
+#include "Test.hxx"
+
+#include "HistogramBuffer.hxx"
+
+#include <TH1.h>
+
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief values of delta T histograms, with both ends of the range,
+     * underflow, overflow and NaN
+     */
+    std::vector<double> MakeValues(unsigned int inSeed, int inNumberOfValues)
+    {
+        std::mt19937 tempRandom(inSeed);
+        std::uniform_real_distribution<double> tempValue(-15.0, 15.0);
+        std::vector<double> tempValues = {-10.0, 10.0, 0.0, -10.5, 12.0,
+            std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::infinity()};
+        for (int i = 0; i < inNumberOfValues; ++i)
+        {
+            tempValues.push_back(tempValue(tempRandom));
+        }
+        return tempValues;
+    }
+
+    /**
+     * @brief compare all bins, underflow and overflow included
+     */
+    void CheckSameBins(const HistogramBuffer& inBuffer, const TH1& inHistogram)
+    {
+        CHECK(inBuffer.GetNumberOfBins() == inHistogram.GetNbinsX());
+        for (int i = 0; i < inHistogram.GetNbinsX() + 2; ++i)
+        {
+            CHECK(inBuffer.GetBinContent(i) == inHistogram.GetBinContent(i));
+        }
+    }
+}
+
+TEST_CASE(HistogramBufferFillMatchesTH1F)
+{
+    const std::vector<double> tempValues = MakeValues(1, 10000);
+    TH1F tempHistogram("", "", 100, -10, 10);
+    HistogramBuffer tempBuffer(tempHistogram);
+    for (std::size_t i = 0; i < tempValues.size(); ++i)
+    {
+        // weights exact in float, so sums of TH1F are exact too
+        const double tempWeight = i % 3 == 0 ? 0.5 : 2.0;
+        tempHistogram.Fill(tempValues[i], tempWeight);
+        tempBuffer.Fill(tempValues[i], tempWeight);
+    }
+    CheckSameBins(tempBuffer, tempHistogram);
+    CHECK(tempHistogram.GetBinContent(0) > 0);
+    CHECK(tempHistogram.GetBinContent(101) > 0);
+}
+
+TEST_CASE(HistogramBufferMergeAndAddToMatchTH1F)
+{
+    // one buffer per worker, merged and added to the histogram of the run
+    const std::vector<double> tempValues = MakeValues(2, 10000);
+    TH1F tempDirect("", "", 100, -10, 10);
+    TH1F tempMerged("", "", 100, -10, 10);
+    tempDirect.Fill(1.0);
+    tempMerged.Fill(1.0);
+
+    HistogramBuffer tempRun(tempMerged);
+    std::vector<HistogramBuffer> tempWorkers(4, HistogramBuffer(tempMerged));
+    for (std::size_t i = 0; i < tempValues.size(); ++i)
+    {
+        tempDirect.Fill(tempValues[i]);
+        tempWorkers[i % tempWorkers.size()].Fill(tempValues[i]);
+    }
+    for (const HistogramBuffer& tempWorker : tempWorkers)
+    {
+        tempRun.Merge(tempWorker);
+    }
+    tempRun.AddTo(tempMerged);
+    for (int i = 0; i < tempDirect.GetNbinsX() + 2; ++i)
+    {
+        CHECK(tempMerged.GetBinContent(i) == tempDirect.GetBinContent(i));
+    }
+
+    tempRun.Reset();
+    for (const double tempContent : tempRun.GetContents())
+    {
+        CHECK(tempContent == 0);
+    }
+}
+
+TEST_CASE(HistogramBufferSetContents)
+{
+    const std::vector<double> tempValues = MakeValues(3, 1000);
+    TH1F tempHistogram("", "", 100, -10, 10);
+    HistogramBuffer tempBuffer(tempHistogram);
+    for (const double tempValue : tempValues)
+    {
+        tempHistogram.Fill(tempValue);
+        tempBuffer.Fill(tempValue);
+    }
+
+    // restored contents, as on resume from a checkpoint
+    HistogramBuffer tempRestored(100, -10, 10);
+    CHECK(tempRestored.SetContents(tempBuffer.GetContents()));
+    CheckSameBins(tempRestored, tempHistogram);
+
+    TH1F tempFromRestored("", "", 100, -10, 10);
+    tempRestored.AddTo(tempFromRestored);
+    for (int i = 0; i < tempHistogram.GetNbinsX() + 2; ++i)
+    {
+        CHECK(tempFromRestored.GetBinContent(i) == tempHistogram.GetBinContent(i));
+    }
+
+    // contents of another binning are rejected, contents are kept
+    CHECK(!tempRestored.SetContents(std::vector<double>(50, 1.0)));
+    CheckSameBins(tempRestored, tempHistogram);
+}
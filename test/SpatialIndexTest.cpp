@@ -0,0 +1,194 @@
+#include "Test.hxx"
+
+#include "EventAnalysis.hxx"
+#include "SpatialIndex.hxx"
+#include "SyntheticEvent.hxx"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief layout of positions of a test snapshot
+     */
+    enum Layout
+    {
+        kRandom = 0,
+        kPlane, //all objects at z = 5
+        kLine, //all objects on the x axis
+        kSamePoint //every third object at one of a few points
+    };
+
+    /**
+     * @brief snapshot of inNumberOfObjects objects of random kind,
+     * some of them with NaN position
+     */
+    ObjectSnapshot MakeSnapshot(std::mt19937& inRandom, int inNumberOfObjects, Layout inLayout)
+    {
+        std::uniform_real_distribution<double> tempPosition(-1000.0, 1000.0);
+        ObjectSnapshot tempSnapshot;
+        for (int i = 0; i < inNumberOfObjects; ++i)
+        {
+            double x = tempPosition(inRandom);
+            double y = tempPosition(inRandom);
+            double z = tempPosition(inRandom);
+            if (inLayout == kPlane)
+            {
+                z = 5;
+            }
+            else if (inLayout == kLine)
+            {
+                y = 0;
+                z = 0;
+            }
+            else if (inLayout == kSamePoint && i % 3 == 0)
+            {
+                x = std::round(x / 500) * 500;
+                y = x;
+                z = x;
+            }
+            if (i % 17 == 5)
+            {
+                x = std::numeric_limits<double>::quiet_NaN();
+            }
+            tempSnapshot.Add(TLorentzVector(x, y, z, 0), inRandom() % 3, i, NULL, 0);
+        }
+        return tempSnapshot;
+    }
+
+    /**
+     * @brief compare all queries of inSpatialIndex with brute force
+     * @details objects which are neither track nor cluster, or have NaN
+     * position, are not indexed.
+     */
+    void CheckQuery(const SpatialIndex& inSpatialIndex, const ObjectSnapshot& inSnapshot,
+            const double inPoint[3], double inRadius, int inKind, int inExcludedRow)
+    {
+        std::vector<int> tempExpected;
+        int tempNearest = -1;
+        double tempNearestDistance = std::numeric_limits<double>::infinity();
+        for (std::size_t i = 0; i < inSnapshot.GetSize(); ++i)
+        {
+            const int tempKind = inSnapshot.GetKind()[i];
+            if (tempKind == ObjectSnapshot::kOther || !std::isfinite(inSnapshot.GetX()[i])
+                    || (inKind >= 0 && tempKind != inKind))
+            {
+                continue;
+            }
+            const double dx = inSnapshot.GetX()[i] - inPoint[0];
+            const double dy = inSnapshot.GetY()[i] - inPoint[1];
+            const double dz = inSnapshot.GetZ()[i] - inPoint[2];
+            const double tempDistance = dx * dx + dy * dy + dz * dz;
+            if (tempDistance <= inRadius * inRadius)
+            {
+                tempExpected.push_back(i);
+            }
+            if (static_cast<int>(i) != inExcludedRow && tempDistance < tempNearestDistance)
+            {
+                tempNearestDistance = tempDistance;
+                tempNearest = i;
+            }
+        }
+
+        std::vector<int> tempRows;
+        inSpatialIndex.FindInRadius(inPoint[0], inPoint[1], inPoint[2], inRadius, inKind, tempRows);
+        CHECK(tempRows == tempExpected);
+        CHECK(inSpatialIndex.CountInRadius(inPoint[0], inPoint[1], inPoint[2], inRadius, inKind)
+                == static_cast<int>(tempExpected.size()));
+
+        double tempDistance = -1;
+        CHECK(inSpatialIndex.FindNearest(inPoint[0], inPoint[1], inPoint[2], inKind, inExcludedRow, &tempDistance)
+                == tempNearest);
+        if (tempNearest >= 0)
+        {
+            CHECK(std::abs(tempDistance - std::sqrt(tempNearestDistance)) < 1e-9);
+        }
+    }
+
+    /**
+     * @brief build index of random snapshots of inLayout and query it
+     * @param double inQueryScale: query points are up to inQueryScale
+     * times the extent of the objects, > 1 queries outside the grid
+     */
+    void CheckLayout(Layout inLayout, int inMaximumObjects, double inQueryScale)
+    {
+        std::mt19937 tempRandom(inLayout + 1);
+        std::uniform_real_distribution<double> tempPosition(-1000.0, 1000.0);
+        SpatialIndex tempSpatialIndex;
+        for (int tempEvent = 0; tempEvent < 200; ++tempEvent)
+        {
+            const int tempNumberOfObjects = tempRandom() % (inMaximumObjects + 1);
+            const ObjectSnapshot tempSnapshot = MakeSnapshot(tempRandom, tempNumberOfObjects, inLayout);
+            // the same index is reused for every event
+            tempSpatialIndex.Build(tempSnapshot);
+            for (int tempQuery = 0; tempQuery < 20; ++tempQuery)
+            {
+                double tempPoint[3] = {tempPosition(tempRandom) * inQueryScale,
+                    tempPosition(tempRandom) * inQueryScale, tempPosition(tempRandom) * inQueryScale};
+                if (inLayout == kPlane && tempQuery % 2 == 0)
+                {
+                    tempPoint[2] = 5;
+                }
+                const double tempRadius = std::abs(tempPosition(tempRandom)) / 3;
+                const int tempKind = static_cast<int>(tempRandom() % 4) - 1;
+                const int tempExcludedRow = tempNumberOfObjects > 0 ? tempRandom() % tempNumberOfObjects : -1;
+                CheckQuery(tempSpatialIndex, tempSnapshot, tempPoint, tempRadius, tempKind, tempExcludedRow);
+            }
+        }
+    }
+}
+
+TEST_CASE(SpatialIndexRandomObjects)
+{
+    CheckLayout(kRandom, 200, 1.0);
+}
+
+TEST_CASE(SpatialIndexDegenerateObjects)
+{
+    CheckLayout(kPlane, 200, 1.0);
+    CheckLayout(kLine, 200, 1.0);
+    CheckLayout(kSamePoint, 200, 1.0);
+}
+
+TEST_CASE(SpatialIndexSingleObject)
+{
+    CheckLayout(kRandom, 1, 1.0);
+    CheckLayout(kPlane, 1, 3.0);
+}
+
+TEST_CASE(SpatialIndexQueryOutsideGrid)
+{
+    CheckLayout(kRandom, 200, 5.0);
+    CheckLayout(kLine, 200, 5.0);
+}
+
+TEST_CASE(FirstObjectIsolationMatchesSpatialIndex)
+{
+    for (unsigned int seed = 1; seed <= 50; ++seed)
+    {
+        SyntheticEvent::Config tempConfig;
+        tempConfig.seed = seed;
+        tempConfig.numberOfTracks = 1 + seed % 20;
+        SyntheticEvent tempEvent(tempConfig);
+        EventAnalysis tempEventAnalysis(tempEvent.GetEvent());
+        tempEventAnalysis.SetTruthCounters();
+        Cube::Handle<Cube::AlgorithmResult> topResult(tempEvent.GetEvent(), false);
+        tempEventAnalysis.CollectObjects(topResult, tempEvent.GetMainTrajectories().data(),
+                tempEvent.GetMainTrajectories().size());
+        if (tempEventAnalysis.SetFirstObject() != EventAnalysis::kSuccess)
+        {
+            continue;
+        }
+
+        const int tempFirst = tempEventAnalysis.GetFirstObjectIndex();
+        const TLorentzVector tempPosition = tempEventAnalysis.GetSnapshot().GetPosition(tempFirst);
+        double tempExpected = std::numeric_limits<double>::infinity();
+        tempEventAnalysis.GetSpatialIndex().FindNearest(tempPosition.X(), tempPosition.Y(), tempPosition.Z(),
+                ObjectSnapshot::kTrack, tempFirst, &tempExpected);
+        const double tempIsolation = tempEventAnalysis.GetFirstObjectIsolation();
+        CHECK(tempIsolation == tempExpected || std::abs(tempIsolation - tempExpected) < 1e-9);
+    }
+}
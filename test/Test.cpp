@@ -0,0 +1,53 @@
+#include "Test.hxx"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief registered tests, constructed on first use so that
+     * registration order of translation units does not matter
+     */
+    std::vector<std::pair<std::string, Test::Function>>& GetTests()
+    {
+        static std::vector<std::pair<std::string, Test::Function>> tests;
+        return tests;
+    }
+
+    /**
+     * @brief number of failed checks
+     */
+    int gNumberOfFailures = 0;
+}
+
+bool Test::Register(const char* inName, Function inFunction)
+{
+    GetTests().emplace_back(inName, inFunction);
+    return true;
+}
+
+void Test::Fail(const char* inCondition, const char* inFile, int inLine)
+{
+    ++gNumberOfFailures;
+    std::cout << inFile << ":" << inLine << ": check failed: " << inCondition << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    int numberOfFailedTests = 0;
+    for (const std::pair<std::string, Test::Function>& test : GetTests())
+    {
+        int tempFailures = gNumberOfFailures;
+        test.second();
+        bool tempPassed = gNumberOfFailures == tempFailures;
+        if (!tempPassed)
+        {
+            ++numberOfFailedTests;
+        }
+        std::cout << (tempPassed ? "[pass] " : "[FAIL] ") << test.first << std::endl;
+    }
+    std::cout << GetTests().size() - numberOfFailedTests << "/" << GetTests().size() << " tests passed" << std::endl;
+    return numberOfFailedTests == 0 ? 0 : 1;
+}
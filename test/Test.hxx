@@ -0,0 +1,48 @@
+#ifndef TEST_HXX
+#define TEST_HXX
+
+#include <iostream>
+
+/**
+ * @brief minimal test harness of test_analysis_test
+ * @details TEST_CASE(name) defines and registers a test function,
+ * CHECK(condition) reports a failed condition with file and line but
+ * keeps running the test. \n
+ * main() of Test.cpp runs all registered tests and returns 1 if any
+ * check failed, so ctest reports the failure.
+ * @date 2026-10-17
+ */
+namespace Test
+{
+    /**
+     * @brief test function
+     */
+    typedef void (*Function)();
+
+    /**
+     * @brief register test function, called by TEST_CASE
+     * @return bool always true
+     */
+    bool Register(const char* inName, Function inFunction);
+
+    /**
+     * @brief report failed check, called by CHECK
+     */
+    void Fail(const char* inCondition, const char* inFile, int inLine);
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static const bool name##Registered = Test::Register(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            Test::Fail(#condition, __FILE__, __LINE__); \
+        } \
+    } while (false)
+
+#endif
@@ -0,0 +1,244 @@
+#include "Test.hxx"
+
+#include "TruthIndex.hxx"
+#include "SyntheticEvent.hxx"
+
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief flags checked by IsDescendantOf
+     */
+    const unsigned int kFlags[] = {
+        TruthIndex::kMuonAncestor, TruthIndex::kNeutronAncestor, TruthIndex::kProtonAncestor,
+        TruthIndex::kGammaAncestor, TruthIndex::kElectronAncestor,
+        TruthIndex::kNeutronAncestor | TruthIndex::kGammaAncestor
+    };
+
+    /**
+     * @brief primary ancestor by walking parents of G4Trajectories
+     * @return int TruthIndex::kNoTrajectory if trajectory is not in event
+     */
+    int FindPrimaryAncestor(Cube::Event* inEvent, int inTrajectoryId)
+    {
+        Cube::Event::G4TrajectoryContainer::iterator it = inEvent->G4Trajectories.find(inTrajectoryId);
+        if (it == inEvent->G4Trajectories.end())
+        {
+            return TruthIndex::kNoTrajectory;
+        }
+        int tempPrimaryId = inTrajectoryId;
+        while (it != inEvent->G4Trajectories.end())
+        {
+            tempPrimaryId = it->first;
+            it = inEvent->G4Trajectories.find(it->second->GetParentId());
+        }
+        return tempPrimaryId;
+    }
+
+    /**
+     * @brief true if any ancestor (not trajectory itself) has one of inFlags,
+     * by walking parents of G4Trajectories
+     */
+    bool IsDescendantOf(Cube::Event* inEvent, int inTrajectoryId, unsigned int inFlags)
+    {
+        Cube::Event::G4TrajectoryContainer::iterator it = inEvent->G4Trajectories.find(inTrajectoryId);
+        while (it != inEvent->G4Trajectories.end())
+        {
+            it = inEvent->G4Trajectories.find(it->second->GetParentId());
+            if (it != inEvent->G4Trajectories.end() && (TruthIndex::GetPdgFlag(it->second->GetPDGCode()) & inFlags))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief add trajectory to event
+     */
+    void AddTrajectory(Cube::Event& inEvent, int inTrackId, int inParentId, int inPDGCode)
+    {
+        Cube::Handle<Cube::G4Trajectory> tempTrajectory(new Cube::G4Trajectory);
+        tempTrajectory->SetTrackId(inTrackId);
+        tempTrajectory->SetParentId(inParentId);
+        tempTrajectory->SetPDGCode(inPDGCode);
+        inEvent.G4Trajectories[inTrackId] = tempTrajectory;
+    }
+
+    /**
+     * @brief ancestry by recursive parent walk, as before TruthIndex
+     * resolved it in Build()
+     * @details a parent which is not in G4Trajectories ends the walk,
+     * the trajectory is then primary.
+     */
+    TruthIndex::TrajectoryInfo ResolveRecursively(Cube::Event* inEvent, int inTrajectoryId)
+    {
+        const Cube::Handle<Cube::G4Trajectory>& gt = inEvent->G4Trajectories[inTrajectoryId];
+        TruthIndex::TrajectoryInfo tempInfo;
+        tempInfo.pdg = gt->GetPDGCode();
+        tempInfo.parentId = gt->GetParentId();
+        Cube::Event::G4TrajectoryContainer::iterator parent = inEvent->G4Trajectories.find(tempInfo.parentId);
+        if (parent == inEvent->G4Trajectories.end())
+        {
+            tempInfo.primaryId = inTrajectoryId;
+            return tempInfo;
+        }
+        const TruthIndex::TrajectoryInfo tempParent = ResolveRecursively(inEvent, parent->first);
+        tempInfo.primaryId = tempParent.primaryId;
+        tempInfo.depth = tempParent.depth + 1;
+        tempInfo.ancestorFlags = tempParent.ancestorFlags | TruthIndex::GetPdgFlag(tempParent.pdg);
+        return tempInfo;
+    }
+
+    /**
+     * @brief compare every query of inTruthIndex with brute force
+     * @details ids from below the first to above the last trajectory are
+     * queried, so missing ids (gaps and both ends) are covered.
+     */
+    void CheckAgainstG4Trajectories(const TruthIndex& inTruthIndex, Cube::Event* inEvent)
+    {
+        const int tempFirstId = inEvent->G4Trajectories.begin()->first;
+        const int tempLastId = inEvent->G4Trajectories.rbegin()->first;
+        for (int id = tempFirstId - 2; id <= tempLastId + 2; ++id)
+        {
+            Cube::Event::G4TrajectoryContainer::iterator it = inEvent->G4Trajectories.find(id);
+            const bool tempFound = it != inEvent->G4Trajectories.end();
+            CHECK((inTruthIndex.Find(id) != NULL) == tempFound);
+            CHECK(inTruthIndex.GetTrajectoryPdg(id) == (tempFound ? it->second->GetPDGCode() : 0));
+            CHECK(inTruthIndex.GetPrimaryAncestor(id) == FindPrimaryAncestor(inEvent, id));
+            for (unsigned int tempFlags : kFlags)
+            {
+                CHECK(inTruthIndex.IsDescendantOf(id, tempFlags) == IsDescendantOf(inEvent, id, tempFlags));
+            }
+        }
+        CHECK(inTruthIndex.GetPrimaryAncestor(TruthIndex::kNoTrajectory) == TruthIndex::kNoTrajectory);
+    }
+
+    /**
+     * @brief compare pdg and parent id of every object with G4Trajectories
+     */
+    void CheckObjects(TruthIndex& inTruthIndex, const SyntheticEvent& inEvent)
+    {
+        Cube::Handle<Cube::ReconObjectContainer> tempObjects = inEvent.GetEvent()->GetObjectContainer("final");
+        for (std::size_t i = 0; i < tempObjects->size(); ++i)
+        {
+            const int tempTrajectoryId = inEvent.GetMainTrajectories()[i];
+            inTruthIndex.SetMainTrajectory((*tempObjects)[i], tempTrajectoryId);
+            CHECK(inTruthIndex.GetMainTrajectory((*tempObjects)[i]) == tempTrajectoryId);
+
+            Cube::Event::G4TrajectoryContainer::iterator it = inEvent.GetEvent()->G4Trajectories.find(tempTrajectoryId);
+            const bool tempFound = it != inEvent.GetEvent()->G4Trajectories.end();
+            CHECK(inTruthIndex.GetPdg((*tempObjects)[i]) == (tempFound ? it->second->GetPDGCode() : 0));
+            CHECK(inTruthIndex.GetParentID((*tempObjects)[i]) == (tempFound ? it->second->GetParentId() : 0));
+        }
+    }
+}
+
+TEST_CASE(TruthIndexContiguousIds)
+{
+    // ids 1..N of SyntheticEvent take the contiguous-id path
+    for (unsigned int seed = 1; seed <= 10; ++seed)
+    {
+        SyntheticEvent::Config tempConfig;
+        tempConfig.seed = seed;
+        SyntheticEvent tempEvent(tempConfig);
+        TruthIndex tempTruthIndex;
+        tempTruthIndex.Build(tempEvent.GetEvent());
+        CheckAgainstG4Trajectories(tempTruthIndex, tempEvent.GetEvent());
+        CheckObjects(tempTruthIndex, tempEvent);
+    }
+}
+
+TEST_CASE(TruthIndexIdGapsAndMissingParents)
+{
+    // erasing trajectories makes gaps, so ids take the lower_bound path,
+    // and children of erased trajectories have a parent not in the table
+    for (unsigned int seed = 1; seed <= 10; ++seed)
+    {
+        SyntheticEvent::Config tempConfig;
+        tempConfig.seed = seed;
+        SyntheticEvent tempEvent(tempConfig);
+        Cube::Event* tempG4Event = tempEvent.GetEvent();
+        std::vector<int> tempErased;
+        for (const Cube::Event::G4TrajectoryContainer::value_type& tempTrajectory : tempG4Event->G4Trajectories)
+        {
+            const int tempParentId = tempTrajectory.second->GetParentId();
+            if (tempParentId > 1 && tempParentId % 3 == static_cast<int>(seed % 3))
+            {
+                tempErased.push_back(tempParentId);
+            }
+        }
+        CHECK(!tempErased.empty());
+        for (int tempId : tempErased)
+        {
+            tempG4Event->G4Trajectories.erase(tempId);
+        }
+
+        TruthIndex tempTruthIndex;
+        tempTruthIndex.Build(tempG4Event);
+        CheckAgainstG4Trajectories(tempTruthIndex, tempG4Event);
+        CheckObjects(tempTruthIndex, tempEvent);
+
+        // reuse of the same index after Clear()
+        tempTruthIndex.Clear();
+        CHECK(tempTruthIndex.Find(1) == NULL);
+        tempTruthIndex.Build(tempG4Event);
+        CheckAgainstG4Trajectories(tempTruthIndex, tempG4Event);
+    }
+}
+
+TEST_CASE(TruthIndexResolveAncestry)
+{
+    Cube::Event tempEvent;
+    // chain 10 -> 11 -> 12 -> 13 -> 14 -> 5, deeper than 2 and with a
+    // child (5) before its ancestors in id order
+    AddTrajectory(tempEvent, 10, -1, 13);
+    AddTrajectory(tempEvent, 11, 10, 2112);
+    AddTrajectory(tempEvent, 12, 11, 2212);
+    AddTrajectory(tempEvent, 13, 12, 22);
+    AddTrajectory(tempEvent, 14, 13, 11);
+    AddTrajectory(tempEvent, 5, 14, 11);
+    // 11 is shared ancestor of 12 and 15, 16 resolves through 15
+    AddTrajectory(tempEvent, 15, 11, 22);
+    AddTrajectory(tempEvent, 16, 15, 11);
+    // parents 99 and 7 are not in G4Trajectories
+    AddTrajectory(tempEvent, 20, 99, 2212);
+    AddTrajectory(tempEvent, 21, 20, 2112);
+    AddTrajectory(tempEvent, 22, 7, 211);
+    AddTrajectory(tempEvent, 23, 22, 22);
+    // second primary sharing nothing with the first
+    AddTrajectory(tempEvent, 30, -1, 2112);
+    AddTrajectory(tempEvent, 31, 30, 2212);
+    AddTrajectory(tempEvent, 32, 31, 22);
+    AddTrajectory(tempEvent, 33, 30, 22);
+
+    TruthIndex tempTruthIndex;
+    tempTruthIndex.Build(&tempEvent);
+    for (const Cube::Event::G4TrajectoryContainer::value_type& tempTrajectory : tempEvent.G4Trajectories)
+    {
+        const TruthIndex::TrajectoryInfo* tempInfo = tempTruthIndex.Find(tempTrajectory.first);
+        const TruthIndex::TrajectoryInfo tempExpected = ResolveRecursively(&tempEvent, tempTrajectory.first);
+        CHECK(tempInfo != NULL);
+        if (tempInfo)
+        {
+            CHECK(tempInfo->pdg == tempExpected.pdg);
+            CHECK(tempInfo->parentId == tempExpected.parentId);
+            CHECK(tempInfo->primaryId == tempExpected.primaryId);
+            CHECK(tempInfo->depth == tempExpected.depth);
+            CHECK(tempInfo->ancestorFlags == tempExpected.ancestorFlags);
+        }
+    }
+    CheckAgainstG4Trajectories(tempTruthIndex, &tempEvent);
+
+    // spot checks of the hand-built chains
+    CHECK(tempTruthIndex.Find(5)->depth == 5);
+    CHECK(tempTruthIndex.GetPrimaryAncestor(5) == 10);
+    CHECK(tempTruthIndex.GetPrimaryAncestor(16) == 10);
+    CHECK(tempTruthIndex.IsDescendantOf(16, TruthIndex::kNeutronAncestor));
+    CHECK(!tempTruthIndex.IsDescendantOf(16, TruthIndex::kProtonAncestor));
+    CHECK(tempTruthIndex.GetPrimaryAncestor(21) == 20);
+    CHECK(tempTruthIndex.Find(22)->depth == 0);
+    CHECK(tempTruthIndex.IsDescendantOf(23, TruthIndex::kPionAncestor));
+    CHECK(!tempTruthIndex.IsDescendantOf(32, TruthIndex::kMuonAncestor));
+}
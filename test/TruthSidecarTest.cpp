@@ -0,0 +1,114 @@
+#include "Test.hxx"
+
+#include "TruthSidecar.hxx"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const std::string kInputFileName = "test_analysis_test.input";
+
+    /**
+     * @brief main trajectory ids of each entry, entry 2 has no objects
+     */
+    const std::vector<std::vector<int>> kEntries = {{1, 5, 7}, {2}, {}, {3, 3, 9, 12}, {-1, 4}};
+
+    /**
+     * @brief write input file, its size and time are the key of the sidecar
+     */
+    void WriteInput(const std::string& inContents)
+    {
+        std::ofstream(kInputFileName, std::ios::binary) << inContents;
+    }
+
+    /**
+     * @brief save sidecar of kEntries
+     */
+    bool SaveSidecar()
+    {
+        TruthSidecar tempSidecar(kInputFileName);
+        for (const std::vector<int>& tempEntry : kEntries)
+        {
+            ObjectSnapshot tempSnapshot;
+            for (int tempTrajectoryId : tempEntry)
+            {
+                tempSnapshot.Add(TLorentzVector(), ObjectSnapshot::kTrack, tempTrajectoryId, NULL, 0);
+            }
+            tempSidecar.AddEntry(tempSnapshot);
+        }
+        CHECK(!tempSidecar.Save(kEntries.size() + 1));
+        return tempSidecar.Save(kEntries.size());
+    }
+
+    void Cleanup()
+    {
+        std::remove((kInputFileName + ".truth").c_str());
+        std::remove(kInputFileName.c_str());
+    }
+}
+
+TEST_CASE(TruthSidecarRoundTrip)
+{
+    WriteInput("input");
+    CHECK(SaveSidecar());
+
+    TruthSidecar tempSidecar(kInputFileName);
+    CHECK(tempSidecar.Open(kEntries.size()));
+    CHECK(tempSidecar.IsOpen());
+    for (std::size_t i = 0; i < kEntries.size(); ++i)
+    {
+        CHECK(tempSidecar.GetNumberOfObjects(i) == static_cast<int>(kEntries[i].size()));
+        const int* tempMainTrajectories = tempSidecar.GetMainTrajectories(i);
+        CHECK(tempMainTrajectories != NULL);
+        if (tempMainTrajectories)
+        {
+            CHECK(std::vector<int>(tempMainTrajectories, tempMainTrajectories + kEntries[i].size()) == kEntries[i]);
+        }
+    }
+    CHECK(tempSidecar.GetNumberOfObjects(-1) == -1);
+    CHECK(tempSidecar.GetNumberOfObjects(kEntries.size()) == -1);
+    CHECK(tempSidecar.GetMainTrajectories(kEntries.size()) == NULL);
+
+    // input of another number of entries
+    CHECK(!tempSidecar.Open(kEntries.size() - 1));
+    CHECK(!tempSidecar.IsOpen());
+    CHECK(tempSidecar.GetMainTrajectories(0) == NULL);
+    Cleanup();
+}
+
+TEST_CASE(TruthSidecarRejectsStaleFile)
+{
+    WriteInput("input");
+    CHECK(SaveSidecar());
+
+    // input changed after the sidecar was written: other key
+    WriteInput("changed input");
+    CHECK(!TruthSidecar(kInputFileName).Open(kEntries.size()));
+
+    // truncated column, offsets and header
+    WriteInput("input");
+    CHECK(SaveSidecar());
+    const std::string tempSidecarFileName = kInputFileName + ".truth";
+    struct stat tempStat;
+    CHECK(stat(tempSidecarFileName.c_str(), &tempStat) == 0);
+    for (off_t tempSize : {static_cast<off_t>(tempStat.st_size - 4), static_cast<off_t>(tempStat.st_size / 2),
+            static_cast<off_t>(16), static_cast<off_t>(0)})
+    {
+        CHECK(SaveSidecar());
+        CHECK(TruthSidecar(kInputFileName).Open(kEntries.size()));
+        CHECK(truncate(tempSidecarFileName.c_str(), tempSize) == 0);
+        CHECK(!TruthSidecar(kInputFileName).Open(kEntries.size()));
+    }
+
+    // missing sidecar and missing input
+    std::remove(tempSidecarFileName.c_str());
+    CHECK(!TruthSidecar(kInputFileName).Open(kEntries.size()));
+    Cleanup();
+    CHECK(!TruthSidecar(kInputFileName).Open(kEntries.size()));
+}